@@ -22,183 +22,344 @@
 #include <ast/queries.h>
 #include <boost/variant/get.hpp>
 #include <util/ast_visitors/partial_eval_expression.h>
-#include <util/ast_visitors/replace_equation.h>
-#include <util/ast_visitors/replace_statement.h>
+#include <util/ast_visitors/replace_many.h>
 #include <causalize/state_variables_finder.h>
 #include <algorithm>
 #include <vector>
 
 namespace Modelica {
+namespace {
+/// Index map k -> outer(inner(k)), an empty map being the identity
+LMap composeIndex(LMap outer, LMap inner)
+{
+  if (outer.empty()) return inner;
+  if (inner.empty()) return outer;
+  return outer.compose(inner);
+}
+
+bool isIdentity(LMap map) { return map.empty() || (map.gain_().front() == 1 && map.off_().front() == 0); }
+
+/// True for an equation that holds whatever its variables are, such as the
+/// b = b left over from the cycle a = b; b = a once a is replaced by b
+bool isTrivial(const Equation &e)
+{
+  if (is<Equality>(e)) return get<Equality>(e).left() == get<Equality>(e).right();
+  if (is<ForEq>(e)) {
+    const EquationList &els = get<ForEq>(e).elements();
+    foreach_(const Equation &el, els) if (!isTrivial(el)) return false;
+    return !els.empty();
+  }
+  return false;
+}
+
+void removeTrivial(EquationList &eqs) { eqs.erase(std::remove_if(eqs.begin(), eqs.end(), isTrivial), eqs.end()); }
+
+Set indexSet(Integer lo, Integer step, Integer hi)
+{
+  OrdCT<Interval> ints(1, Interval(lo, step, hi));
+  AtomSet as = AtomSet(MultiInterval(ints));
+  Set s;
+  s.addAtomSet(as);
+  return s;
+}
+
+/// Matches a subscript of the form gain * index + offset with integer coefficients
+bool affineIndex(const Expression &e, const Name &index, Integer &gain, Integer &offset)
+{
+  if (is<Integer>(e)) {
+    gain = 0;
+    offset = get<Integer>(e);
+    return true;
+  } else if (is<Reference>(e)) {
+    const Reference &r = get<Reference>(e);
+    gain = 1;
+    offset = 0;
+    return r.ref().size() == 1 && get<1>(r.ref().front()).empty() && refName(r) == index;
+  } else if (is<Output>(e)) {
+    const OptExpList &args = get<Output>(e).args();
+    return args.size() == 1 && args.front() && affineIndex(args.front().get(), index, gain, offset);
+  } else if (is<UnaryOp>(e)) {
+    const UnaryOp &u = get<UnaryOp>(e);
+    if (u.op() == Not || !affineIndex(u.exp(), index, gain, offset)) return false;
+    if (u.op() == Minus) {
+      gain = -gain;
+      offset = -offset;
+    }
+    return true;
+  } else if (is<BinOp>(e)) {
+    const BinOp &b = get<BinOp>(e);
+    Integer gl, ol, gr, orr;
+    if (!affineIndex(b.left(), index, gl, ol) || !affineIndex(b.right(), index, gr, orr)) return false;
+    switch (b.op()) {
+    case Add:
+      gain = gl + gr;
+      offset = ol + orr;
+      return true;
+    case Sub:
+      gain = gl - gr;
+      offset = ol - orr;
+      return true;
+    case Mult:
+      if (gl != 0 && gr != 0) return false;
+      gain = gl * orr + gr * ol;
+      offset = ol * orr;
+      return true;
+    default:
+      return false;
+    }
+  }
+  return false;
+}
+}  // namespace
+
 RemoveAlias::RemoveAlias(MMO_Class &c) : _c(c)
 {
   StateVariablesFinder svf(c);
   svf.findStateVariables();
 }
 void RemoveAlias::removeAliasEquations()
+{
+  // Each sweep collects every alias it can see and one batched substitution
+  // rewrites the model. Another sweep is only needed when the substitution
+  // uncovers new aliases (e.g. a = 0 turns b = c + a into b = c).
+  PartialEvalExpression eval(_c.syms_ref(), true);
+  while (collectAliases(eval)) substituteAliases();
+}
+Name RemoveAlias::find(Name n, bool &negated, LMap &map)
+{
+  std::vector<Name> path;
+  boost::unordered_map<Name, Alias>::iterator it;
+  while ((it = _alias.find(n)) != _alias.end()) {
+    path.push_back(n);
+    n = it->second.parent;
+  }
+  // Path compression, the sign and index map of every node become relative to the root
+  negated = false;
+  map = LMap();
+  for (std::vector<Name>::reverse_iterator p = path.rbegin(); p != path.rend(); ++p) {
+    Alias &a = _alias[*p];
+    negated = negated != a.negated;
+    map = composeIndex(map, a.map);
+    a = Alias(n, negated, map);
+  }
+  return n;
+}
+bool RemoveAlias::collectAliases(const PartialEvalExpression &eval)
 {
   EquationList &el = _c.equations_ref().equations_ref();
   VarSymbolTable &syms = _c.syms_ref();
-  int aliased;
-  do {
-    aliased = 0;
-    foreach_(Equation & e, el)
-    {
-      if (is<Equality>(e)) {
-        Equality &eq = boost::get<Equality>(e);
-        PartialEvalExpression eval(syms, true);
-        Expression left = Apply(eval, eq.left_ref());
-        Expression right = Apply(eval, eq.right_ref());
-        eq.left_ref() = left;
-        eq.right_ref() = right;
-        if (is<UnaryOp>(left)) {  // -a = ... ---> a = - ...
-          UnaryOp u = get<UnaryOp>(left);
-          if (u.op() == Minus) {
-            Expression exp = u.exp();
-            if (is<Reference>(exp)) {
-              left = exp;
-              right = UnaryOp(right, Minus);
-              right = Apply(eval, right);
-            }
+  EquationList kept;
+  kept.reserve(el.size());
+  foreach_(Equation & e, el)
+  {
+    if (is<Equality>(e)) {
+      Equality &eq = boost::get<Equality>(e);
+      eval.simplify(eq.left_ref());
+      eval.simplify(eq.right_ref());
+      Expression left = eq.left(), right = eq.right();
+      if (is<UnaryOp>(left)) {  // -a = ... ---> a = - ...
+        UnaryOp u = get<UnaryOp>(left);
+        if (u.op() == Minus) {
+          Expression exp = u.exp();
+          if (is<Reference>(exp)) {
+            left = exp;
+            right = UnaryOp(right, Minus);
+            eval.simplify(right);
           }
         }
-        if (is<Real>(left) || is<Integer>(left)) {  // Always put contant values on the right
-          Expression t = right;
-          right = left;
-          left = t;
-        }
-        if (isZero(right) && is<BinOp>(left)) {
-          BinOp bop = get<BinOp>(left);
-          if (bop.op() == Add) {
-            right = UnaryOp(bop.right(), Minus);
-            right = Apply(eval, right);
-            left = bop.left();
-          }
-          if (bop.op() == Sub) {
-            right = bop.right();
-            left = bop.left();
-          }
+      }
+      if (is<Real>(left) || is<Integer>(left)) {  // Always put contant values on the right
+        Expression t = right;
+        right = left;
+        left = t;
+      }
+      if (isZero(right) && is<BinOp>(left)) {
+        BinOp bop = get<BinOp>(left);
+        if (bop.op() == Add) {
+          right = UnaryOp(bop.right(), Minus);
+          eval.simplify(right);
+          left = bop.left();
         }
-        if (is<UnaryOp>(left) && get<UnaryOp>(left).op() == Minus && is<Reference>(get<UnaryOp>(left).exp())) {
-          left = get<UnaryOp>(left).exp();
-          right = UnaryOp(right, Minus);
-          right = Apply(eval, right);
+        if (bop.op() == Sub) {
+          right = bop.right();
+          left = bop.left();
         }
-        if (is<Reference>(left) && is<Reference>(right)) {  // a = b case
-          Reference l = get<Reference>(left);
-          Reference r = get<Reference>(right);
-          if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
-          if (r.ref().size() > 1) ERROR("antialias must be run on a flat model");
-          if ((get<1>(l.ref().front()).size() == 0) && (get<1>(r.ref().front()).size() == 0)) {
-            if (isVariable(refName(l), syms) && isVariable(refName(r), syms)) {
-              if (!isState(refName(l), syms)) {
-                el.erase(std::find(el.begin(), el.end(), e));
-                alias(l, r);
-                aliased = 1;
-                break;
-              } else if (!isState(refName(r), syms)) {
-                el.erase(std::find(el.begin(), el.end(), e));
-                alias(r, l);
-                aliased = 1;
-                break;
-              }
-            }
-          }
-        } else if (is<Reference>(left) && is<UnaryOp>(right)) {  //  a= -b case
-          Reference l = get<Reference>(left);
-          UnaryOp u = get<UnaryOp>(right);
-          if (is<Reference>(u.exp())) {
-            Reference r = get<Reference>(u.exp());
-            if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
-            if (r.ref().size() > 1) ERROR("antialias must be run on a flat model");
-            if ((get<1>(l.ref().front()).size() == 0) && (get<1>(r.ref().front()).size() == 0)) {
-              if (isVariable(refName(l), syms) && isVariable(refName(r), syms)) {
-                if (!isState(refName(l), syms)) {
-                  el.erase(std::find(el.begin(), el.end(), e));
-                  alias(l, right);
-                  aliased = 1;
-                  break;
-                }
-              }
+      }
+      if (is<UnaryOp>(left) && get<UnaryOp>(left).op() == Minus && is<Reference>(get<UnaryOp>(left).exp())) {
+        left = Expression(get<UnaryOp>(left).exp());
+        right = UnaryOp(right, Minus);
+        eval.simplify(right);
+      }
+      bool opposite = false;
+      if (is<Reference>(left) && is<UnaryOp>(right) && get<UnaryOp>(right).op() == Minus && is<Reference>(get<UnaryOp>(right).exp())) {
+        right = Expression(get<UnaryOp>(right).exp());
+        opposite = true;
+      }
+      if (is<Reference>(left) && is<Reference>(right)) {  // a = b and a = -b cases
+        Reference l = get<Reference>(left);
+        Reference r = get<Reference>(right);
+        if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
+        if (r.ref().size() > 1) ERROR("antialias must be run on a flat model");
+        if ((get<1>(l.ref().front()).size() == 0) && (get<1>(r.ref().front()).size() == 0) && isVariable(refName(l), syms) &&
+            isVariable(refName(r), syms)) {
+          bool nl, nr;
+          LMap ml, mr;
+          Name rl = find(refName(l), nl, ml), rr = find(refName(r), nr, mr);
+          // Aliases of constants, of themselves or of shifted arrays are looked at again once substituted
+          if (rl != rr && !_value.count(rl) && !_value.count(rr) && isIdentity(ml) && isIdentity(mr)) {
+            bool negated = (nl != nr) != opposite;
+            if (!isState(rl, syms)) {
+              _alias[rl] = Alias(rr, negated);
+              continue;
+            } else if (!opposite && !isState(rr, syms)) {
+              _alias[rr] = Alias(rl, negated);
+              continue;
             }
           }
-        } else if (is<Reference>(left) && (is<Real>(right) || is<Integer>(right))) {  //  a= K case
-          Reference l = get<Reference>(left);
-          if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
-          if (get<1>(l.ref().front()).size() > 0) continue;
-          el.erase(std::find(el.begin(), el.end(), e));
-          alias(l, right);
-          aliased = 1;
-          break;
-        }
-      } else if (is<ForEq>(e)) {
-        ForEq feq = get<ForEq>(e);
-        ERROR_UNLESS(feq.elements().size() == 1, "Antialias not supported on multi-equation for");
-        ERROR_UNLESS(is<Equality>(feq.elements().front()), "Antialias not supported on non equality equation inside for");
-        Equality eq = get<Equality>(feq.elements().front());
-        Expression left = eq.left();
-        Expression right = eq.right();
-        if (isZero(left)) {
-          Expression t = right;
-          right = left;
-          left = t;
         }
-        PartialEvalExpression eval(syms);
-        OptExp o_ind = feq.range().indexes().front().exp();
-        if (!o_ind) continue;
-        if (!is<Range>(o_ind.get())) continue;
-        Range range = get<Range>(o_ind.get());
-        Expression start_exp = Apply(eval, range.start_ref());
-        Expression end_exp = Apply(eval, range.end_ref());
-        if (!is<Integer>(start_exp) || !is<Integer>(end_exp)) continue;
-        int start = get<Integer>(start_exp);
-        int end = get<Integer>(end_exp);
-        if (start != 1) continue;
-        if (is<Reference>(left) && is<Reference>(right)) {  // a = b case
-          Reference l = get<Reference>(left);
-          Reference r = get<Reference>(right);
-          if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
-          if (r.ref().size() > 1) ERROR("antialias must be run on a flat model");
-          if (isVariable(refName(l), syms) && isVariable(refName(r), syms)) {
-            if (isState(refName(r), syms) || isState(refName(l), syms)) continue;
-            if (!isArray1(refName(r), syms) || !isArray1(refName(l), syms)) continue;
-            Expression size_l = arraySize(refName(l), syms);
-            Expression size_r = arraySize(refName(r), syms);
-            size_l = Apply(eval, size_l);
-            size_r = Apply(eval, size_r);
-            if (!is<Integer>(size_l) || !is<Integer>(size_r)) continue;
-            int sz_l = get<Integer>(size_l);
-            int sz_r = get<Integer>(size_r);
-            if (end != sz_l || end != sz_r) continue;
-            el.erase(std::find(el.begin(), el.end(), e));
-            std::cerr << "Aliasing " << l << " with  " << r << "\n";
-            alias(l, r);
-            aliased = 1;
-            break;
+      } else if (is<Reference>(left) && (is<Real>(right) || is<Integer>(right))) {  //  a= K case
+        Reference l = get<Reference>(left);
+        if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
+        if (get<1>(l.ref().front()).size() == 0) {
+          bool nl;
+          LMap ml;
+          Name rl = find(refName(l), nl, ml);
+          if (!_value.count(rl) && ml.empty()) {
+            _value[rl] = nl ? Expression(UnaryOp(right, Minus)) : right;
+            continue;
           }
         }
       }
+    } else if (is<ForEq>(e)) {
+      ForEq &feq = get<ForEq>(e);
+      ERROR_UNLESS(feq.elements().size() == 1, "Antialias not supported on multi-equation for");
+      ERROR_UNLESS(is<Equality>(feq.elements().front()), "Antialias not supported on non equality equation inside for");
+      if (collectArrayAlias(feq)) continue;
     }
-  } while (aliased);
+    kept.push_back(std::move(e));
+  }
+  el.swap(kept);
+  return !_alias.empty() || !_value.empty();
 }
-void RemoveAlias::alias(Reference a, Expression b)
-{  // Remove a from the model and replace every occurence with b
+bool RemoveAlias::collectArrayAlias(const ForEq &feq)
+{  // for i in lo:step:hi loop a[ga * i + oa] = [-] b[gb * i + ob]; end for
   VarSymbolTable &syms = _c.syms_ref();
-  syms.remove(refName(a));
-
-  // Remove variable a
-  std::vector<Name> &vars = _c.variables_ref();
-  std::vector<Name>::iterator pos = std::find(vars.begin(), vars.end(), refName(a));
-  if (pos != vars.end()) vars.erase(pos);
-  ReplaceEquation req(a, b);
-  foreach_(Equation & eq, _c.equations_ref().equations_ref())
+  const IndexList &indexes = feq.range().indexes();
+  const Equality &eq = get<Equality>(feq.elements().front());
+  Expression left = eq.left(), right = eq.right();
+  bool opposite = false;
+  if (is<UnaryOp>(right) && get<UnaryOp>(right).op() == Minus) {
+    Expression exp = get<UnaryOp>(right).exp();
+    right = exp;
+    opposite = true;
+  } else if (is<UnaryOp>(left) && get<UnaryOp>(left).op() == Minus) {
+    Expression exp = get<UnaryOp>(left).exp();
+    left = exp;
+    opposite = true;
+  }
+  if (indexes.size() != 1 || !indexes.front().exp() || !is<Range>(indexes.front().exp().get()) || !is<Reference>(left) ||
+      !is<Reference>(right))
+    return false;
+  PartialEvalExpression range_eval(syms);
+  const Range &range = get<Range>(indexes.front().exp().get());
+  Expression lo = Apply(range_eval, range.start()), hi = Apply(range_eval, range.end());
+  Expression step = range.step() ? Apply(range_eval, range.step().get()) : Expression(1);
+  if (!is<Integer>(lo) || !is<Integer>(hi) || !is<Integer>(step) || get<Integer>(step) <= 0 || get<Integer>(lo) > get<Integer>(hi))
+    return false;
+  Reference l = get<Reference>(left);
+  Reference r = get<Reference>(right);
+  if (l.ref().size() > 1) ERROR("antialias must be run on a flat model");
+  if (r.ref().size() > 1) ERROR("antialias must be run on a flat model");
+  Name nl = refName(l), nr = refName(r);
+  // The for index itself is not in the symbol table
+  if (!syms.lookup(nl) || !syms.lookup(nr)) return false;
+  if (nl == nr || !isVariable(nl, syms) || !isVariable(nr, syms) || !isArray1(nl, syms) || !isArray1(nr, syms)) return false;
+  const ExpList &sl = get<1>(l.ref().front()), &sr = get<1>(r.ref().front());
+  Integer gl, ol, gr, orr;
+  if (sl.size() != 1 || sr.size() != 1 || !affineIndex(sl.front(), indexes.front().name(), gl, ol) ||
+      !affineIndex(sr.front(), indexes.front().name(), gr, orr) || gl <= 0 || gr <= 0)
+    return false;
+  Expression size_l = Apply(range_eval, arraySize(nl, syms)), size_r = Apply(range_eval, arraySize(nr, syms));
+  if (!is<Integer>(size_l) || !is<Integer>(size_r)) return false;
+  // Index sets touched on each side. Only an alias that covers a whole array
+  // eliminates it, a partial one would need the array to be split.
+  Set dom = indexSet(get<Integer>(lo), get<Integer>(step), get<Integer>(hi));
+  LMap fl, fr;
+  fl.addGO(gl, ol);
+  fr.addGO(gr, orr);
+  PWLMap pwl(OrdCT<Set>(1, dom), OrdCT<LMap>(1, fl)), pwr(OrdCT<Set>(1, dom), OrdCT<LMap>(1, fr));
+  Set image_l = pwl.image(dom), image_r = pwr.image(dom);
+  Set all_l = indexSet(1, 1, get<Integer>(size_l)), all_r = indexSet(1, 1, get<Integer>(size_r));
+  if (image_l.cap(all_l) != image_l || image_r.cap(all_r) != image_r) return false;
+  if (image_l != all_l || isState(nl, syms)) {
+    if (image_r != all_r || isState(nr, syms)) return false;
+    std::swap(nl, nr);
+    std::swap(fl, fr);
+  }
+  if (_alias.count(nl) || _value.count(nl)) return false;  // Already eliminated in this sweep
+  // Element k of the eliminated array is element fr(fl^-1(k)) of the other one
+  LMap inv = fl.invLMap();
+  LMap shift = fr.compose(inv);
+  Real gain = shift.gain_().front(), offset = shift.off_().front();
+  if (gain != (Integer)gain || offset != (Integer)offset) return false;
+  bool negated;
+  LMap map;
+  Name root = find(nr, negated, map);
+  if (root == nl || _value.count(root)) return false;
+  _alias[nl] = Alias(root, negated != opposite, composeIndex(map, shift));
+  return true;
+}
+void RemoveAlias::substituteAliases()
+{  // Remove the eliminated variables from the model and replace every occurence at once
+  VarSymbolTable &syms = _c.syms_ref();
+  ReplaceMap replace;
+  ReplaceArrayMap arrays;
+  std::vector<Name> eliminated;
+  boost::unordered_map<Name, Alias>::const_iterator it;
+  for (it = _alias.begin(); it != _alias.end(); ++it) eliminated.push_back(it->first);
+  PartialEvalExpression size_eval(syms);
+  foreach_(const Name &n, eliminated)
   {
-    // std::cerr << eq << " is now ";
-    eq = Apply(req, eq);
-    // std::cerr << eq << "\n";
+    bool negated;
+    LMap map;
+    Name root = find(n, negated, map);
+    if (!_value.count(root) && isArray1(n, syms) && isArray1(root, syms)) {
+      // Arrays are renamed element by element so that subscripted references keep their sign
+      Integer gain = 1, offset = 0, size = 0;
+      if (!isIdentity(map)) {
+        gain = map.gain_().front();
+        offset = map.off_().front();
+        Expression s = Apply(size_eval, arraySize(n, syms));
+        if (is<Integer>(s)) size = get<Integer>(s);
+      }
+      arrays[n] = ArrayRename(root, gain, offset, size, negated);
+      continue;
+    }
+    Expression rep = _value.count(root) ? _value[root] : Expression(Reference(root));
+    replace[n] = negated ? Expression(UnaryOp(rep, Minus)) : rep;
   }
+  boost::unordered_map<Name, Expression>::const_iterator vit;
+  for (vit = _value.begin(); vit != _value.end(); ++vit) replace[vit->first] = vit->second;
+
+  std::vector<Name> &vars = _c.variables_ref();
+  ReplaceMap::const_iterator rit;
+  for (rit = replace.begin(); rit != replace.end(); ++rit) syms.remove(rit->first);
+  ReplaceArrayMap::const_iterator ait;
+  for (ait = arrays.begin(); ait != arrays.end(); ++ait) syms.remove(ait->first);
+  std::vector<Name> remaining;
+  remaining.reserve(vars.size());
+  foreach_(const Name &v, vars) if (!replace.count(v) && !arrays.count(v)) remaining.push_back(v);
+  vars.swap(remaining);
+
+  ReplaceManyEquation req(replace, arrays);
+  foreach_(Equation & eq, _c.equations_ref().equations_ref()) eq = Apply(req, eq);
   foreach_(Equation & eq, _c.initial_eqs_ref().equations_ref()) eq = Apply(req, eq);
-  ReplaceStatement rst(a, b);
+  removeTrivial(_c.equations_ref().equations_ref());
+  removeTrivial(_c.initial_eqs_ref().equations_ref());
+  ReplaceManyStatement rst(replace, arrays);
   foreach_(Statement & st, _c.statements_ref().statements_ref()) st = Apply(rst, st);
   foreach_(Statement & st, _c.initial_sts_ref().statements_ref()) st = Apply(rst, st);
+  _alias.clear();
+  _value.clear();
 }
 };  // namespace Modelica
@@ -19,12 +19,32 @@
 
 #ifndef REMOVE_ALIAS_H
 #define REMOVE_ALIAS_H
+#include <boost/unordered_map.hpp>
 #include <mmo/mmo_class.h>
+#include <util/ast_visitors/partial_eval_expression.h>
+#include <util/graph/graph_definition.h>
 
 namespace Modelica {
 class RemoveAlias {
   MMO_Class &_c;
-  void alias(Reference a, Expression b);
+  /// An eliminated variable is equal to its parent, or the opposite of it when
+  /// negated. For arrays aliased in a for-equation, element k of the variable
+  /// is element map(k) of the parent; an empty map is the identity.
+  struct Alias {
+    Alias() : negated(false){};
+    Alias(Name p, bool n, LMap m = LMap()) : parent(p), negated(n), map(m){};
+    Name parent;
+    bool negated;
+    LMap map;
+  };
+  /// Union-find of the aliases found in a sweep
+  boost::unordered_map<Name, Alias> _alias;
+  /// Roots of the union-find that were found equal to a constant
+  boost::unordered_map<Name, Expression> _value;
+  Name find(Name n, bool &negated, LMap &map);
+  bool collectAliases(const PartialEvalExpression &eval);
+  bool collectArrayAlias(const ForEq &feq);
+  void substituteAliases();
 
   public:
   RemoveAlias(MMO_Class &c);
@@ -28,6 +28,8 @@
 #include <boost/variant/variant.hpp>
 #include <boost/variant/recursive_wrapper.hpp>
 #include <list>
+#include <ostream>
+#include <utility>
 
 template <typename T>
 struct List : public std::list<T> {
@@ -96,6 +98,13 @@ typedef std::vector<Option<TypePrefix>> TypePrefixes;
 typedef std::vector<Option<ClassPrefix>> ClassPrefixes;
 const char *classPrefix(Option<ClassPrefix>);
 const char *typePrefix(Option<TypePrefix>);
+
+/// @brief Inserts n spaces without building a string for them
+struct Indent {
+  explicit Indent(long n) : n(n) {}
+  long n;
+};
+std::ostream &operator<<(std::ostream &out, const Indent &indent);
 }  // namespace AST
 }  // namespace Modelica
 
@@ -103,25 +112,28 @@ const char *typePrefix(Option<TypePrefix>);
 #define ApplyThis(X) boost::apply_visitor(*this, X)
 #define Apply(X, Y) boost::apply_visitor(X, Y)
 #define foreach_ BOOST_FOREACH
-#define member_(X, Y) \
-  X Y##_;             \
-  X Y() const;        \
-  void set_##Y(X x);  \
+#define member_(X, Y)  \
+  X Y##_;              \
+  X const &Y() const;  \
+  void set_##Y(X x);   \
   X &Y##_ref();
-#define member_imp(C, X, Y)          \
-  X C::Y() const { return Y##_; }    \
-  void C::set_##Y(X x) { Y##_ = x; } \
+#define member_imp(C, X, Y)                     \
+  X const &C::Y() const { return Y##_; }        \
+  void C::set_##Y(X x) { Y##_ = std::move(x); } \
   X &C::Y##_ref() { return Y##_; }
 #define comparable(X) bool operator==(const X &other) const;
+#define hashable(X) friend std::size_t hash_value(const X &);
 #define printable(X) friend std::ostream &operator<<(std::ostream &out, const X &);
 #define INDENTSPACE 2
-#define INDENT std::string(depth, ' ')
+#define INDENT Modelica::AST::Indent(depth)
 #define BEGIN_BLOCK depth += INDENTSPACE;
 #define END_BLOCK depth -= INDENTSPACE;
 #define SKIP_BLOCK_START   \
   long depth_save = depth; \
   depth = 0;
 #define SKIP_BLOCK_END depth = depth_save;
-extern long depth;
+// Indentation of the printers, kept per thread so that several threads can
+// print separate pieces of a tree at once
+extern thread_local long depth;
 
 #endif
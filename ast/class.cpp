@@ -101,7 +101,7 @@ std::ostream& operator<<(std::ostream& out, const StoredDef& s)  // output
     if (s.name()) out << s.name().get();
     out << ";\n";
   }
-  foreach_(ClassType e, s.classes()) out << e << ";" << std::endl;
+  foreach_(ClassType e, s.classes()) out << e << ";\n";
   return out;
 }
 
@@ -118,6 +118,8 @@ StoredDef::StoredDef(boost::optional<Name> name, ClassList cl) : classes_(cl), n
 member_imp(DerClass, bool, encapsulated);
 member_imp(DerClass, Name, name);
 member_imp(DerClass, Name, deriv);
+member_imp(DerClass, IdentList, ident_list);
+member_imp(DerClass, Comment, comment);
 std::ostream& operator<<(std::ostream& out, const DerClass& c)
 {
   if (c.final()) out << "final ";
@@ -132,6 +134,7 @@ member_imp(DefClass, Name, definition);
 member_imp(DefClass, TypePrefixes, type_prefixes);
 member_imp(DefClass, Option<ExpList>, indices);
 member_imp(DefClass, Option<ClassModification>, modification);
+member_imp(DefClass, Comment, comment);
 std::ostream& operator<<(std::ostream& out, const DefClass& c)
 {
   if (c.final()) out << "final ";
@@ -153,6 +156,8 @@ std::ostream& operator<<(std::ostream& out, const ExtendsClass& c)
 member_imp(ExtendsClass, bool, encapsulated);
 member_imp(ExtendsClass, Name, name);
 member_imp(ExtendsClass, Option<ClassModification>, modification);
+member_imp(ExtendsClass, StringComment, st_comment);
+member_imp(ExtendsClass, Composition, composition);
 member_imp(EnumClass, bool, encapsulated);
 std::ostream& operator<<(std::ostream& out, const EnumClass& c)
 {
@@ -170,6 +175,7 @@ member_imp(ExtendsClass, bool, final);
 member_imp(EnumClass, bool, final);
 member_imp(EnumClass, Name, name);
 member_imp(EnumClass, EnumSpec, enum_spec);
+member_imp(EnumClass, Comment, comment);
 member_imp(DerClass, ClassPrefixes, prefixes);
 member_imp(DefClass, ClassPrefixes, prefixes);
 member_imp(ExtendsClass, ClassPrefixes, prefixes);
@@ -190,9 +196,8 @@ std::ostream& operator<<(std::ostream& out, const Protected& p)  // output
 Composition::Composition(
     ElemList el, CompElemList comp_el,
     boost::optional<boost::fusion::vector3<boost::optional<String>, boost::optional<External>, boost::optional<Annotation>>> ext)
-    : elements_(el), comp_elem_(comp_el)
+    : elements_(el), comp_elem_(comp_el), external_(ext)
 {
-  if (ext) external_ = true;
 }
 
 Name className(ClassType c)
@@ -49,13 +49,13 @@ typedef boost::variant<EquationSection, StatementSection, Public, Protected> Com
 typedef std::vector<CompElement> CompElemList;
 
 template <typename T>
-inline bool is(CompElement c)
+inline bool is(const CompElement &c)
 {
   return c.type() == typeid(T);
 }
 
 struct Composition {
-  Composition(){};
+  Composition() : external_(false){};
   Composition(ElemList, CompElemList,
               boost::optional<boost::fusion::vector3<boost::optional<String>, boost::optional<External>, boost::optional<Annotation>>>);
   member_(ElemList, elements);
@@ -68,6 +68,7 @@ struct Composition {
 };
 
 struct ExtendsClass {
+  ExtendsClass() : encapsulated_(false), final_(false) {}
   member_(Name, name);
   member_(Option<ClassModification>, modification);
   member_(StringComment, st_comment);
@@ -79,6 +80,7 @@ struct ExtendsClass {
 };
 
 struct DerClass {
+  DerClass() : encapsulated_(false), final_(false) {}
   member_(Name, name);
   member_(Name, deriv);
   member_(IdentList, ident_list);
@@ -90,6 +92,7 @@ struct DerClass {
 };
 
 struct EnumClass {
+  EnumClass() : encapsulated_(false), final_(false) {}
   member_(Name, name);
   member_(EnumSpec, enum_spec);
   member_(Comment, comment);
@@ -100,6 +103,7 @@ struct EnumClass {
 };
 
 struct DefClass {
+  DefClass() : encapsulated_(false), final_(false) {}
   member_(Name, name);
   member_(TypePrefixes, type_prefixes);
   member_(Name, definition);
@@ -131,7 +135,7 @@ struct ClassType_ {
 };
 
 template <typename T>
-bool is(ClassType c)
+bool is(const ClassType &c)
 {
   return c.type() == typeid(T);
 }
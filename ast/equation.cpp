@@ -22,6 +22,7 @@
 namespace Modelica {
 namespace AST {
 Equality::Equality(Expression l, Expression r) : left_(l), right_(r){};
+member_imp(EquationBase, Option<Comment>, comment);
 member_imp(Equality, Expression, left);
 member_imp(Equality, Expression, right);
 std::ostream& operator<<(std::ostream& out, const Equality& e)  // output
@@ -60,7 +61,7 @@ std::ostream& operator<<(std::ostream& out, const EquationSection& es)
     if (es.initial()) out << "initial ";
     out << "equation\n";
   }
-  foreach_(Equation e, es.equations()) out << INDENT << e << ";\n";
+  foreach_(const Equation &e, es.equations()) out << INDENT << e << ";\n";
   return out;
 }
 }  // namespace AST
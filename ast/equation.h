@@ -64,7 +64,7 @@ struct IfEq;
 
 typedef variant<Connect, Equality, CallEq, recursive_wrapper<ForEq>, recursive_wrapper<IfEq>, recursive_wrapper<WhenEq>> Equation;
 template <typename T>
-bool is(Equation e)
+bool is(const Equation &e)
 {
   return e.type() == typeid(T);
 }
@@ -78,20 +78,20 @@ struct For {
 
   friend std::ostream& operator<<(std::ostream& out, const For& f)  // output
   {
-    out << "for " << f.range() << " loop" << std::endl;
+    out << "for " << f.range() << " loop\n";
     BEGIN_BLOCK;
-    foreach_(E e, f.elements()) out << INDENT << e << ";" << std::endl;
+    foreach_(const E &e, f.elements()) out << INDENT << e << ";\n";
     END_BLOCK;
     out << INDENT << "end for";
     return out;
   }
   bool operator==(const For& other) const { return other.range() == range() && other.elements() == elements(); }
   bool operator!=(const For& other) const { return !(other.range() == range() && other.elements() == elements()); }
-  Indexes range() const { return r; }
+  const Indexes& range() const { return r; }
   Indexes& range_ref() { return r; }
   void set_range(Indexes i) { r = i; }
 
-  std::vector<E> elements() const { return els; }
+  const std::vector<E>& elements() const { return els; }
   std::vector<E>& elements_ref() { return els; }
   Indexes r;
   std::vector<E> els;
@@ -107,21 +107,21 @@ struct If {
   If(Expression cond, std::vector<E> then, ElseList elseif) : c(cond), els(then), elsesif(elseif){};
   friend std::ostream& operator<<(std::ostream& out, const If& i)  // output
   {
-    out << "if " << i.cond() << " then " << std::endl;
+    out << "if " << i.cond() << " then \n";
     BEGIN_BLOCK;
-    foreach_(E e, i.elements()) out << INDENT << e << ";" << std::endl;
+    foreach_(const E &e, i.elements()) out << INDENT << e << ";\n";
     END_BLOCK;
-    foreach_(Else e, i.elseif())
+    foreach_(const Else &e, i.elseif())
     {
-      out << INDENT << "elseif " << get<0>(e) << " then " << std::endl;
+      out << INDENT << "elseif " << get<0>(e) << " then \n";
       BEGIN_BLOCK;
-      foreach_(E el, get<1>(e)) out << INDENT << el << ";" << std::endl;
+      foreach_(const E &el, get<1>(e)) out << INDENT << el << ";\n";
       END_BLOCK;
     }
     if (i.ifnot().size()) {
-      out << INDENT << "else " << std::endl;
+      out << INDENT << "else \n";
       BEGIN_BLOCK;
-      foreach_(E e, i.ifnot()) out << INDENT << e << ";" << std::endl;
+      foreach_(const E &e, i.ifnot()) out << INDENT << e << ";\n";
       END_BLOCK;
     }
     out << INDENT << "end if";
@@ -136,16 +136,16 @@ struct If {
   {
     return (other.cond() == cond() && other.elements() == elements() && other.ifnot() == ifnot() && other.elseif() == elseif());
   }
-  Expression cond() const { return c; }
+  const Expression& cond() const { return c; }
   Expression& cond_ref() { return c; }
 
-  std::vector<E> elements() const { return els; }
+  const std::vector<E>& elements() const { return els; }
   std::vector<E>& elements_ref() { return els; }
 
-  std::vector<E> ifnot() const { return elses; }
+  const std::vector<E>& ifnot() const { return elses; }
   std::vector<E>& ifnot_ref() { return elses; }
 
-  ElseList elseif() const { return elsesif; }
+  const ElseList& elseif() const { return elsesif; }
   ElseList& elseif_ref() { return elsesif; }
 
   Expression c;
@@ -163,15 +163,15 @@ struct When {
 
   friend std::ostream& operator<<(std::ostream& out, const When& w)  // output
   {
-    out << "when " << w.cond() << " then " << std::endl;
+    out << "when " << w.cond() << " then \n";
     BEGIN_BLOCK;
-    foreach_(E e, w.elements()) out << INDENT << e << ";" << std::endl;
+    foreach_(const E &e, w.elements()) out << INDENT << e << ";\n";
     END_BLOCK;
-    foreach_(Else e, w.elsewhen())
+    foreach_(const Else &e, w.elsewhen())
     {
-      out << INDENT << "elsewhen " << get<0>(e) << " then " << std::endl;
+      out << INDENT << "elsewhen " << get<0>(e) << " then \n";
       BEGIN_BLOCK;
-      foreach_(E ee, get<1>(e)) out << INDENT << ee << ";" << std::endl;
+      foreach_(const E &ee, get<1>(e)) out << INDENT << ee << ";\n";
       END_BLOCK;
     }
     out << INDENT << "end when";
@@ -188,13 +188,13 @@ struct When {
     return !(other.cond() == cond() && other.elements() == elements() && other.elsewhen() == elsewhen());
   }
 
-  Expression cond() const { return c; }
+  const Expression& cond() const { return c; }
   Expression& cond_ref() { return c; }
 
-  std::vector<E> elements() const { return els; }
+  const std::vector<E>& elements() const { return els; }
   std::vector<E>& elements_ref() { return els; }
 
-  ElseList elsewhen() const { return elsew; }
+  const ElseList& elsewhen() const { return elsew; }
   ElseList& elsewhen_ref() { return elsew; }
 
   Expression c;
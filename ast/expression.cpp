@@ -17,18 +17,27 @@
 
 ******************************************************************************/
 
+#include <algorithm>
 #include <boost/foreach.hpp>
 #include <boost/variant/get.hpp>
 #include <ast/expression.h>
 #include <util/debug.h>
 
-long depth;
+thread_local long depth;
 namespace Modelica {
 namespace AST {
 
+std::ostream& operator<<(std::ostream& out, const Indent& indent)
+{
+  static const char spaces[] = "                                ";
+  for (long n = indent.n; n > 0; n -= sizeof(spaces) - 1) out.write(spaces, std::min<long>(n, sizeof(spaces) - 1));
+  return out;
+}
+
 const char* BinOpTypeName[] = {" or ", " and ", "<", "<=", ">", ">=", "<>", "==", "+", ".+", "-", ".-", "/", "./", "*", ".*", "^", ".^"};
 const char* UnaryOpTypeName[] = {" not ", "-", "+"};
 
+AddAll::AddAll() : arr_(Symbol(), ExpList()) {}
 AddAll::AddAll(RefTuple a) : arr_(a){}
 
 member_imp(AddAll, RefTuple, arr);
@@ -372,5 +381,80 @@ long printAsCActive(std::ios_base& s) { return printAsC(s); }
 
 void setCFlag(std::ios_base& s, long n) { printAsC(s) = n; }
 
+// Structural hashes. They only look at fields that operator== compares, so
+// equal expressions always hash alike.
+namespace {
+std::size_t hashRefTuple(const RefTuple& rt)
+{
+  std::size_t seed = hash_value(get<0>(rt));
+  boost::hash_combine(seed, get<1>(rt));
+  return seed;
+}
+}  // namespace
+
+std::size_t hash_value(const SubEnd&) { return 1; }
+std::size_t hash_value(const SubAll&) { return 2; }
+std::size_t hash_value(const AddAll& v) { return hashRefTuple(v.arr_); }
+std::size_t hash_value(const String& v) { return boost::hash_value(v.val_); }
+std::size_t hash_value(const Boolean& v) { return boost::hash_value(v.val_); }
+std::size_t hash_value(const BinOp& v)
+{
+  std::size_t seed = boost::hash_value((int)v.op_);
+  boost::hash_combine(seed, v.left_);
+  boost::hash_combine(seed, v.right_);
+  return seed;
+}
+std::size_t hash_value(const IfExp& v)
+{
+  std::size_t seed = boost::hash_value(v.cond_);
+  boost::hash_combine(seed, v.then_);
+  return seed;
+}
+std::size_t hash_value(const Call& v)
+{
+  std::size_t seed = boost::hash_value(v.name_);
+  boost::hash_combine(seed, v.args_);
+  return seed;
+}
+std::size_t hash_value(const Brace& v) { return boost::hash_value(v.args_); }
+std::size_t hash_value(const Bracket& v) { return boost::hash_value(v.args_); }
+std::size_t hash_value(const UnaryOp& v)
+{
+  std::size_t seed = boost::hash_value((int)v.op_);
+  boost::hash_combine(seed, v.exp_);
+  return seed;
+}
+std::size_t hash_value(const ForExp& v) { return boost::hash_value(v.indices_.indexes_.size()); }
+std::size_t hash_value(const Reference& v)
+{
+  std::size_t seed = 0;
+  foreach_(const RefTuple& rt, v.ref_) boost::hash_combine(seed, hashRefTuple(rt));
+  return seed;
+}
+std::size_t hash_value(const Range& v)
+{
+  std::size_t seed = boost::hash_value(v.start_);
+  boost::hash_combine(seed, v.end_);
+  return seed;
+}
+std::size_t hash_value(const Output& v)
+{
+  std::size_t seed = boost::hash_value(v.args_.size());
+  foreach_(const OptExp& e, v.args_) if (e) boost::hash_combine(seed, e.get());
+  return seed;
+}
+std::size_t hash_value(const Named& v)
+{
+  std::size_t seed = boost::hash_value(v.name_);
+  boost::hash_combine(seed, v.exp_);
+  return seed;
+}
+std::size_t hash_value(const FunctionExp& v)
+{
+  std::size_t seed = boost::hash_value(v.name_);
+  boost::hash_combine(seed, v.args_);
+  return seed;
+}
+
 }  // namespace AST
 }  // namespace Modelica
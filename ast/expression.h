@@ -20,6 +20,8 @@
 #ifndef AST_EXPRESSION
 #define AST_EXPRESSION
 #include <ast/ast_types.h>
+#include <ast/symbol.h>
+#include <boost/functional/hash.hpp>
 #include <string>
 #include <iostream>
 #include <vector>
@@ -87,18 +89,20 @@ typedef std::vector<Expression> ExpList;
 typedef std::vector<ExpList> ExpListList;
 typedef Option<Expression> OptExp;
 typedef std::vector<OptExp> OptExpList;
-typedef Pair<Name, ExpList> RefTuple;
+typedef Pair<Symbol, ExpList> RefTuple;
 typedef Pair<Expression, Expression> ExpPair;
 typedef std::vector<RefTuple> Ref;
 typedef std::vector<ExpPair> ElseIf;
 
 struct SubEnd {
   comparable(SubEnd);
+  hashable(SubEnd);
   printable(SubEnd);
 };
 
 struct SubAll {
   comparable(SubAll);
+  hashable(SubAll);
   printable(SubAll);
 };
 
@@ -114,6 +118,7 @@ struct AddAll{
 
   printable(AddAll);
   comparable(AddAll);
+  hashable(AddAll);
 };
 
 struct String {
@@ -122,6 +127,7 @@ struct String {
   String();
   friend std::ostream& operator<<(std::ostream& out, const String& s);
   comparable(String);
+  hashable(String);
   member_(std::string, val);
 };
 
@@ -134,6 +140,7 @@ struct Boolean {
 
   printable(Boolean);
   comparable(Boolean);
+  hashable(Boolean);
   member_(bool, val);
 };
 
@@ -142,6 +149,7 @@ struct BinOp {
   BinOp(Expression l, BinOpType op, Expression r);
 
   comparable(BinOp);
+  hashable(BinOp);
   printable(BinOp);
   member_(Expression, left);
   member_(Expression, right);
@@ -153,6 +161,7 @@ struct IfExp {
   IfExp(Expression a, Expression b, List<ExpPair> elseif, Expression c);
   IfExp(Expression a, Expression b, std::vector<boost::fusion::vector2<Expression, Expression>> elseif, Expression c);
   comparable(IfExp);
+  hashable(IfExp);
   printable(IfExp);
   member_(Expression, cond);
   member_(Expression, then);
@@ -165,6 +174,7 @@ struct Call {
   Call(Name n, ExpList args);
   printable(Call);
   comparable(Call);
+  hashable(Call);
   member_(Name, name);
   member_(ExpList, args)
 };
@@ -191,6 +201,7 @@ struct ForExp {
   ForExp(){};
   ForExp(Expression, Indexes);
   comparable(ForExp);
+  hashable(ForExp);
   printable(ForExp);
   member_(Indexes, indices);
   member_(Expression, exp);
@@ -201,6 +212,7 @@ struct Named {
   Named(Name n, Expression e);
   printable(Named);
   comparable(Named);
+  hashable(Named);
   member_(Name, name);
   member_(Expression, exp);
 };
@@ -210,6 +222,7 @@ struct UnaryOp {
   UnaryOp(Expression e, UnaryOpType op);
   printable(UnaryOp);
   comparable(UnaryOp);
+  hashable(UnaryOp);
   member_(Expression, exp);
   member_(UnaryOpType, op);
 };
@@ -226,6 +239,7 @@ struct Reference {  //:vector<RefTuple>
   Reference(Ref r);
   printable(Reference);
   comparable(Reference);
+  hashable(Reference);
   member_(Ref, ref);
 };
 
@@ -234,6 +248,7 @@ struct Range {
   Range(Expression s, Expression e);
   Range(Expression s, Expression i, Expression e);
   comparable(Range);
+  hashable(Range);
   printable(Range);
   member_(Expression, start);
   member_(OptExp, step);
@@ -246,6 +261,7 @@ struct Output {
   Output(OptExpList l);
   printable(Output);
   comparable(Output);
+  hashable(Output);
   member_(OptExpList, args)
 };
 
@@ -254,6 +270,7 @@ struct FunctionExp {
   FunctionExp(Name n, ExpList args);
   printable(FunctionExp);
   comparable(FunctionExp);
+  hashable(FunctionExp);
   member_(Name, name) member_(ExpList, args)
 };
 
@@ -263,6 +280,7 @@ struct Brace {
   Brace(ExpList args);
   printable(Brace);
   comparable(Brace);
+  hashable(Brace);
   member_(ExpList, args)
 };
 
@@ -271,13 +289,14 @@ struct Bracket {
   Bracket(ExpListList args);
   printable(Bracket);
   comparable(Bracket);
+  hashable(Bracket);
   member_(ExpListList, args)
 };
 
 extern Boolean True, False;
 
 template <typename T>
-inline bool is(Expression e)
+inline bool is(const Expression &e)
 {
   return e.type() == typeid(T);
 }
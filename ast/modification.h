@@ -43,7 +43,7 @@ struct ModAssign {
 struct ModClass;
 typedef boost::variant<ModEq, ModAssign, boost::recursive_wrapper<ModClass>> Modification;
 template <typename T>
-inline bool is(Modification e)
+inline bool is(const Modification &e)
 {
   return e.type() == typeid(T);
 }
@@ -64,7 +64,7 @@ struct ElRedecl;
 struct ElRepl;
 typedef boost::variant<ElMod, boost::recursive_wrapper<ElRepl>, boost::recursive_wrapper<ElRedecl>> Argument;
 template <typename T>
-inline bool is(Argument e)
+inline bool is(const Argument &e)
 {
   return e.type() == typeid(T);
 }
@@ -178,7 +178,7 @@ struct Component1 {
 };
 typedef boost::variant<ShortClass, Component1> ReplArg;
 template <typename T>
-inline bool is(ReplArg r)
+inline bool is(const ReplArg &r)
 {
   return r.type() == typeid(T);
 }
@@ -195,7 +195,7 @@ struct ElRepl {
 typedef boost::variant<ReplArg, ElRepl> RedeclArg;
 
 template <typename T>
-inline bool is(RedeclArg r)
+inline bool is(const RedeclArg &r)
 {
   return r.type() == typeid(T);
 }
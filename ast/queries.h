@@ -46,26 +46,26 @@ inline bool isSum(Expression e)
 
 inline bool isBuiltIn(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  return var_info.get().builtin();
+  return var_info->builtin();
 }
 
 inline bool isRef(Expression e) { return is<Reference>(e); }
 
 inline bool isParameter(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  foreach_(Option<TypePrefix> t, var_info.get().prefixes()) if (t && t.get() == parameter) return true;
+  foreach_(Option<TypePrefix> t, var_info->prefixes()) if (t && t.get() == parameter) return true;
   return false;
 }
 
 inline bool isDiscrete(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  foreach_(Option<TypePrefix> t, var_info.get().prefixes())
+  foreach_(Option<TypePrefix> t, var_info->prefixes())
   {
     if (t && t.get() == discrete) return true;
   }
@@ -74,9 +74,9 @@ inline bool isDiscrete(Name n, const VarSymbolTable& syms)
 
 inline bool isConstant(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  foreach_(Option<TypePrefix> t, var_info.get().prefixes())
+  foreach_(Option<TypePrefix> t, var_info->prefixes())
   {
     if (t && t.get() == constant) return true;
   }
@@ -87,12 +87,12 @@ inline Name refName(Reference r) { return get<0>(r.ref().front()); }
 
 inline bool isVariable(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
   bool is_var = true;
-  if (var_info.get().builtin()) is_var = false;
-  if (var_info.get().type() != "Real") is_var = false;
-  foreach_(Option<TypePrefix> t, var_info.get().prefixes())
+  if (var_info->builtin()) is_var = false;
+  if (var_info->type() != "Real") is_var = false;
+  foreach_(Option<TypePrefix> t, var_info->prefixes())
   {
     if (t && t.get() == constant) is_var = false;
     if (t && t.get() == parameter) is_var = false;
@@ -103,24 +103,24 @@ inline bool isVariable(Name n, const VarSymbolTable& syms)
 
 inline bool isState(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  return var_info.get().state();
+  return var_info->state();
 }
 
 inline bool isArray1(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  if (!var_info.get().indices()) return false;
-  return var_info.get().indices().get().size() == 1;
+  if (!var_info->indices()) return false;
+  return var_info->indices().get().size() == 1;
 }
 
 inline Expression arraySize(Name n, const VarSymbolTable& syms)
 {
-  Option<VarInfo> var_info = syms[n];
+  const VarInfo *var_info = syms.lookup(n);
   if (!var_info) ERROR("No symbol %s", n.c_str());
-  return var_info.get().indices().get().front();
+  return var_info->indices().get().front();
 }
 
 }  // namespace Modelica
@@ -0,0 +1,956 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <ast/serialize.h>
+#include <cstring>
+#include <stdint.h>
+
+namespace Modelica {
+namespace AST {
+
+namespace {
+const char MAGIC[4] = {'M', 'C', 'C', 'A'};
+
+// Sizes, counts and variant tags are fixed width 32 bit words in host byte
+// order; an image is never moved between machines.
+typedef uint32_t Word;
+
+/// Writes every node as its fields in declaration order. Variants are their
+/// which() tag followed by the alternative, optionals a flag byte and
+/// containers their length followed by the elements.
+class Writer : public boost::static_visitor<> {
+  public:
+  Writer(std::string &out) : out_(out) {}
+
+  void word(size_t w)
+  {
+    Word x = w;
+    out_.append(reinterpret_cast<const char *>(&x), sizeof(x));
+  }
+
+  void operator()(bool b) const { out_.push_back(b ? 1 : 0); }
+  void operator()(int i) const { out_.append(reinterpret_cast<const char *>(&i), sizeof(i)); }
+  void operator()(double d) const { out_.append(reinterpret_cast<const char *>(&d), sizeof(d)); }
+  void operator()(const std::string &s) const
+  {
+    Word n = s.size();
+    out_.append(reinterpret_cast<const char *>(&n), sizeof(n));
+    out_.append(s);
+  }
+  void operator()(const Symbol &s) const { (*this)(s.str()); }
+  void operator()(TypePrefix p) const { (*this)(static_cast<int>(p)); }
+  void operator()(ClassPrefix p) const { (*this)(static_cast<int>(p)); }
+  void operator()(BinOpType o) const { (*this)(static_cast<int>(o)); }
+  void operator()(UnaryOpType o) const { (*this)(static_cast<int>(o)); }
+
+  template <typename T>
+  void operator()(const boost::optional<T> &o) const
+  {
+    (*this)(bool(o));
+    if (o) (*this)(o.get());
+  }
+  template <typename T>
+  void operator()(const std::vector<T> &v) const
+  {
+    (*this)(static_cast<int>(v.size()));
+    foreach_(const T &t, v) (*this)(t);
+  }
+  template <typename T>
+  void operator()(const std::list<T> &l) const
+  {
+    (*this)(static_cast<int>(l.size()));
+    foreach_(const T &t, l) (*this)(t);
+  }
+  template <typename A, typename B>
+  void operator()(const boost::tuple<A, B> &t) const
+  {
+    (*this)(boost::get<0>(t));
+    (*this)(boost::get<1>(t));
+  }
+  template <typename T0, typename... TN>
+  void operator()(const boost::variant<T0, TN...> &v) const
+  {
+    (*this)(v.which());
+    boost::apply_visitor(*this, v);
+  }
+
+  // Expressions
+  void operator()(const String &s) const { (*this)(s.val()); }
+  void operator()(const Boolean &b) const { (*this)(b.val()); }
+  void operator()(const SubEnd &) const {}
+  void operator()(const SubAll &) const {}
+  void operator()(const BinOp &b) const
+  {
+    (*this)(b.left());
+    (*this)(b.right());
+    (*this)(b.op());
+  }
+  void operator()(const UnaryOp &u) const
+  {
+    (*this)(u.exp());
+    (*this)(u.op());
+  }
+  void operator()(const Brace &b) const { (*this)(b.args()); }
+  void operator()(const Bracket &b) const { (*this)(b.args()); }
+  void operator()(const Call &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.args());
+  }
+  void operator()(const FunctionExp &f) const
+  {
+    (*this)(f.name());
+    (*this)(f.args());
+  }
+  void operator()(const Index &i) const
+  {
+    (*this)(i.name());
+    (*this)(i.exp());
+  }
+  void operator()(const Indexes &i) const { (*this)(i.indexes()); }
+  void operator()(const ForExp &f) const
+  {
+    (*this)(f.indices());
+    (*this)(f.exp());
+  }
+  void operator()(const IfExp &i) const
+  {
+    (*this)(i.cond());
+    (*this)(i.then());
+    (*this)(i.elseif());
+    (*this)(i.elseexp());
+  }
+  void operator()(const Named &n) const
+  {
+    (*this)(n.name());
+    (*this)(n.exp());
+  }
+  void operator()(const Output &o) const { (*this)(o.args()); }
+  void operator()(const Reference &r) const { (*this)(r.ref()); }
+  void operator()(const Range &r) const
+  {
+    (*this)(r.start());
+    (*this)(r.step());
+    (*this)(r.end());
+  }
+  void operator()(const AddAll &a) const { (*this)(a.arr()); }
+
+  // Modifications
+  void operator()(const ModEq &m) const { (*this)(m.exp()); }
+  void operator()(const ModAssign &m) const { (*this)(m.exp()); }
+  void operator()(const ModClass &m) const
+  {
+    (*this)(m.modification());
+    (*this)(m.exp());
+  }
+  void operator()(const ElMod &m) const
+  {
+    (*this)(m.name());
+    (*this)(m.modification());
+    (*this)(m.st_comment());
+    (*this)(m.each());
+    (*this)(m.final());
+  }
+  void operator()(const ElRepl &r) const
+  {
+    (*this)(r.each());
+    (*this)(r.final());
+    (*this)(r.argument());
+    (*this)(r.constrain());
+  }
+  void operator()(const ElRedecl &r) const
+  {
+    (*this)(r.each());
+    (*this)(r.final());
+    (*this)(r.argument());
+  }
+  void operator()(const Annotation &a) const { (*this)(a.modification()); }
+  void operator()(const Comment &c) const
+  {
+    (*this)(c.st_comment());
+    (*this)(c.annotation());
+  }
+  void operator()(const Enum &e) const
+  {
+    (*this)(e.name());
+    (*this)(e.comment());
+  }
+  void operator()(const EnumSpec &e) const { (*this)(e.list()); }
+  void operator()(const ShortClass &s) const
+  {
+    (*this)(s.prefixes());
+    (*this)(s.name());
+    (*this)(s.type_prefixes());
+    (*this)(s.derived());
+    (*this)(s.indices());
+    (*this)(s.modification());
+    (*this)(s.comment());
+    (*this)(s.enum_spec());
+  }
+  void operator()(const Constrained &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.modification());
+  }
+  void operator()(const Declaration &d) const
+  {
+    (*this)(d.name());
+    (*this)(d.indices());
+    (*this)(d.modification());
+    (*this)(d.comment());
+    (*this)(d.conditional());
+  }
+  void operator()(const Component &c) const
+  {
+    (*this)(c.prefixes());
+    (*this)(c.type());
+    (*this)(c.indices());
+    (*this)(c.declarations());
+    (*this)(c.redeclare());
+    (*this)(c.final());
+    (*this)(c.inner());
+    (*this)(c.outer());
+    (*this)(c.replaceable());
+    (*this)(c.constrained());
+    (*this)(c.constrained_comment());
+  }
+  void operator()(const Component1 &c) const
+  {
+    (*this)(c.prefixes());
+    (*this)(c.type());
+    (*this)(c.declaration());
+  }
+
+  // Elements
+  void operator()(const Extends &e) const
+  {
+    (*this)(e.name());
+    (*this)(e.modification());
+    (*this)(e.annotation());
+  }
+  void operator()(const Import &) const {}
+  void operator()(const ElemClass &e) const
+  {
+    (*this)(e.class_element().get().cl());
+    (*this)(e.replaceable());
+    (*this)(e.redeclare());
+    (*this)(e.final());
+    (*this)(e.inner());
+    (*this)(e.outer());
+    (*this)(e.constrained());
+    (*this)(e.constrained_comment());
+  }
+
+  // Equations and statements
+  void operator()(const Equality &e) const
+  {
+    (*this)(e.comment());
+    (*this)(e.left());
+    (*this)(e.right());
+  }
+  void operator()(const Connect &c) const
+  {
+    (*this)(c.comment());
+    (*this)(c.left());
+    (*this)(c.right());
+  }
+  void operator()(const CallEq &c) const
+  {
+    (*this)(c.comment());
+    (*this)(c.name());
+    (*this)(c.args());
+  }
+  void operator()(const ForEq &f) const
+  {
+    (*this)(f.comment());
+    (*this)(f.range());
+    (*this)(f.elements());
+  }
+  void operator()(const IfEq &i) const
+  {
+    (*this)(i.comment());
+    writeIf(i);
+  }
+  void operator()(const WhenEq &w) const
+  {
+    (*this)(w.comment());
+    writeWhen(w);
+  }
+  void operator()(const EquationSection &e) const
+  {
+    (*this)(e.initial());
+    (*this)(e.equations());
+  }
+  void operator()(const Assign &a) const
+  {
+    (*this)(a.left());
+    (*this)(a.right());
+    (*this)(a.rl());
+  }
+  void operator()(const Break &) const {}
+  void operator()(const Return &) const {}
+  void operator()(const CallSt &c) const
+  {
+    (*this)(c.out());
+    (*this)(c.n());
+    (*this)(c.arg());
+  }
+  void operator()(const IfSt &i) const { writeIf(i); }
+  void operator()(const ForSt &f) const
+  {
+    (*this)(f.range());
+    (*this)(f.elements());
+  }
+  void operator()(const WhenSt &w) const { writeWhen(w); }
+  void operator()(const WhileSt &w) const
+  {
+    (*this)(w.cond());
+    (*this)(w.elements());
+  }
+  void operator()(const StatementSection &s) const
+  {
+    (*this)(s.initial());
+    (*this)(s.statements());
+  }
+
+  // Classes
+  void operator()(const External &e) const
+  {
+    (*this)(e.comp_ref());
+    (*this)(e.fun());
+    (*this)(e.args());
+  }
+  void operator()(const Composition &c) const
+  {
+    (*this)(c.elements());
+    (*this)(c.comp_elem());
+    (*this)(c.external());
+    (*this)(c.language());
+    (*this)(c.call());
+    (*this)(c.ext_annot());
+    (*this)(c.annotation());
+  }
+  void operator()(const Class &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.st_comment());
+    (*this)(c.composition());
+    (*this)(c.end_name());
+    (*this)(c.prefixes());
+    (*this)(c.final());
+    (*this)(c.encapsulated());
+  }
+  void operator()(const DefClass &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.type_prefixes());
+    (*this)(c.definition());
+    (*this)(c.indices());
+    (*this)(c.modification());
+    (*this)(c.comment());
+    (*this)(c.prefixes());
+    (*this)(c.encapsulated());
+    (*this)(c.final());
+  }
+  void operator()(const EnumClass &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.enum_spec());
+    (*this)(c.comment());
+    (*this)(c.prefixes());
+    (*this)(c.encapsulated());
+    (*this)(c.final());
+  }
+  void operator()(const DerClass &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.deriv());
+    (*this)(c.ident_list());
+    (*this)(c.comment());
+    (*this)(c.prefixes());
+    (*this)(c.encapsulated());
+    (*this)(c.final());
+  }
+  void operator()(const ExtendsClass &c) const
+  {
+    (*this)(c.name());
+    (*this)(c.modification());
+    (*this)(c.st_comment());
+    (*this)(c.composition());
+    (*this)(c.prefixes());
+    (*this)(c.encapsulated());
+    (*this)(c.final());
+  }
+  void operator()(const StoredDef &sd) const
+  {
+    (*this)(sd.name());
+    (*this)(sd.within());
+    (*this)(sd.classes());
+  }
+
+  private:
+  template <typename E>
+  void writeIf(const If<E> &i) const
+  {
+    (*this)(i.cond());
+    (*this)(i.elements());
+    (*this)(i.elseif());
+    (*this)(i.ifnot());
+  }
+  template <typename E>
+  void writeWhen(const When<E> &w) const
+  {
+    (*this)(w.cond());
+    (*this)(w.elements());
+    (*this)(w.elsewhen());
+  }
+  std::string &out_;
+};
+
+/// Thrown by Reader when the image does not match what is being read
+struct Malformed {
+};
+
+template <typename T>
+struct Unwrapped {
+  typedef T type;
+};
+template <typename T>
+struct Unwrapped<boost::recursive_wrapper<T>> {
+  typedef T type;
+};
+
+/// The inverse of Writer. Every node is default constructed and then filled
+/// in through its _ref() accessors.
+class Reader {
+  public:
+  Reader(const char *data, size_t size) : next_(data), end_(data + size) {}
+
+  bool atEnd() const { return next_ == end_; }
+
+  void bytes(void *to, size_t n)
+  {
+    if (size_t(end_ - next_) < n) throw Malformed();
+    memcpy(to, next_, n);
+    next_ += n;
+  }
+  Word word()
+  {
+    Word w;
+    bytes(&w, sizeof(w));
+    return w;
+  }
+  // Every element of a container takes at least one byte, which bounds the
+  // count before anything is allocated for it
+  size_t count()
+  {
+    int n;
+    get(n);
+    if (n < 0 || size_t(n) > size_t(end_ - next_)) throw Malformed();
+    return n;
+  }
+
+  void get(bool &b)
+  {
+    char c;
+    bytes(&c, 1);
+    b = c != 0;
+  }
+  void get(int &i) { bytes(&i, sizeof(i)); }
+  void get(double &d) { bytes(&d, sizeof(d)); }
+  void get(std::string &s)
+  {
+    Word n = word();
+    if (size_t(end_ - next_) < n) throw Malformed();
+    s.assign(next_, n);
+    next_ += n;
+  }
+  void get(Symbol &s)
+  {
+    std::string str;
+    get(str);
+    s = Symbol(str);
+  }
+  void get(TypePrefix &p) { p = static_cast<TypePrefix>(enumValue(constant)); }
+  void get(ClassPrefix &p) { p = static_cast<ClassPrefix>(enumValue(function)); }
+  void get(BinOpType &o) { o = static_cast<BinOpType>(enumValue(ElExp)); }
+  void get(UnaryOpType &o) { o = static_cast<UnaryOpType>(enumValue(Plus)); }
+
+  template <typename T>
+  void get(boost::optional<T> &o)
+  {
+    bool present;
+    get(present);
+    if (!present) {
+      o = boost::none;
+      return;
+    }
+    T t;
+    get(t);
+    o = std::move(t);
+  }
+  template <typename T>
+  void get(std::vector<T> &v)
+  {
+    v.resize(count());
+    foreach_(T &t, v) get(t);
+  }
+  template <typename T>
+  void get(std::list<T> &l)
+  {
+    l.clear();
+    for (size_t n = count(); n > 0; n--) {
+      l.push_back(T());
+      get(l.back());
+    }
+  }
+  template <typename A, typename B>
+  void get(boost::tuple<A, B> &t)
+  {
+    get(boost::get<0>(t));
+    get(boost::get<1>(t));
+  }
+  // Pair has no default constructor, so containers of pairs are read element
+  // by element
+  template <typename A, typename B>
+  Pair<A, B> pair()
+  {
+    A a;
+    B b;
+    get(a);
+    get(b);
+    return Pair<A, B>(std::move(a), std::move(b));
+  }
+  template <typename A, typename B>
+  void get(std::vector<Pair<A, B>> &v)
+  {
+    v.clear();
+    size_t n = count();
+    v.reserve(n);
+    for (; n > 0; n--) v.push_back(pair<A, B>());
+  }
+  template <typename A, typename B>
+  void get(std::list<Pair<A, B>> &l)
+  {
+    l.clear();
+    for (size_t n = count(); n > 0; n--) l.push_back(pair<A, B>());
+  }
+  template <typename T0, typename... TN>
+  void get(boost::variant<T0, TN...> &v)
+  {
+    int which;
+    get(which);
+    alternative<boost::variant<T0, TN...>, T0, TN...>(v, which);
+  }
+
+  // Expressions
+  void get(String &s) { get(s.val_ref()); }
+  void get(Boolean &b) { get(b.val_ref()); }
+  void get(SubEnd &) {}
+  void get(SubAll &) {}
+  void get(BinOp &b)
+  {
+    get(b.left_ref());
+    get(b.right_ref());
+    get(b.op_ref());
+  }
+  void get(UnaryOp &u)
+  {
+    get(u.exp_ref());
+    get(u.op_ref());
+  }
+  void get(Brace &b) { get(b.args_ref()); }
+  void get(Bracket &b) { get(b.args_ref()); }
+  void get(Call &c)
+  {
+    get(c.name_ref());
+    get(c.args_ref());
+  }
+  void get(FunctionExp &f)
+  {
+    get(f.name_ref());
+    get(f.args_ref());
+  }
+  void get(Index &i)
+  {
+    get(i.name_ref());
+    get(i.exp_ref());
+  }
+  void get(Indexes &i) { get(i.indexes_ref()); }
+  void get(ForExp &f)
+  {
+    get(f.indices_ref());
+    get(f.exp_ref());
+  }
+  void get(IfExp &i)
+  {
+    get(i.cond_ref());
+    get(i.then_ref());
+    get(i.elseif_ref());
+    get(i.elseexp_ref());
+  }
+  void get(Named &n)
+  {
+    get(n.name_ref());
+    get(n.exp_ref());
+  }
+  void get(Output &o) { get(o.args_ref()); }
+  void get(Reference &r) { get(r.ref_ref()); }
+  void get(Range &r)
+  {
+    get(r.start_ref());
+    get(r.step_ref());
+    get(r.end_ref());
+  }
+  void get(AddAll &a) { a.set_arr(pair<Symbol, ExpList>()); }
+
+  // Modifications
+  void get(ModEq &m) { get(m.exp_ref()); }
+  void get(ModAssign &m) { get(m.exp_ref()); }
+  void get(ModClass &m)
+  {
+    get(m.modification_ref());
+    get(m.exp_ref());
+  }
+  void get(ElMod &m)
+  {
+    get(m.name_ref());
+    get(m.modification_ref());
+    get(m.st_comment_ref());
+    get(m.each_ref());
+    get(m.final_ref());
+  }
+  void get(ElRepl &r)
+  {
+    get(r.each_ref());
+    get(r.final_ref());
+    get(r.argument_ref());
+    get(r.constrain_ref());
+  }
+  void get(ElRedecl &r)
+  {
+    get(r.each_ref());
+    get(r.final_ref());
+    get(r.argument_ref());
+  }
+  void get(Annotation &a) { get(a.modification_ref()); }
+  void get(Comment &c)
+  {
+    get(c.st_comment_ref());
+    get(c.annotation_ref());
+  }
+  void get(Enum &e)
+  {
+    get(e.name_ref());
+    get(e.comment_ref());
+  }
+  void get(EnumSpec &e) { get(e.list_ref()); }
+  void get(ShortClass &s)
+  {
+    get(s.prefixes_ref());
+    get(s.name_ref());
+    get(s.type_prefixes_ref());
+    get(s.derived_ref());
+    get(s.indices_ref());
+    get(s.modification_ref());
+    get(s.comment_ref());
+    get(s.enum_spec_ref());
+  }
+  void get(Constrained &c)
+  {
+    get(c.name_ref());
+    get(c.modification_ref());
+  }
+  void get(Declaration &d)
+  {
+    get(d.name_ref());
+    get(d.indices_ref());
+    get(d.modification_ref());
+    get(d.comment_ref());
+    get(d.conditional_ref());
+  }
+  void get(Component &c)
+  {
+    get(c.prefixes_ref());
+    get(c.type_ref());
+    get(c.indices_ref());
+    get(c.declarations_ref());
+    get(c.redeclare_ref());
+    get(c.final_ref());
+    get(c.inner_ref());
+    get(c.outer_ref());
+    get(c.replaceable_ref());
+    get(c.constrained_ref());
+    get(c.constrained_comment_ref());
+  }
+  void get(Component1 &c)
+  {
+    get(c.prefixes_ref());
+    get(c.type_ref());
+    get(c.declaration_ref());
+  }
+
+  // Elements
+  void get(Extends &e)
+  {
+    get(e.name_ref());
+    get(e.modification_ref());
+    get(e.annotation_ref());
+  }
+  void get(Import &) {}
+  void get(ElemClass &e)
+  {
+    get(e.class_element_ref().get().cl_ref());
+    get(e.replaceable_ref());
+    get(e.redeclare_ref());
+    get(e.final_ref());
+    get(e.inner_ref());
+    get(e.outer_ref());
+    get(e.constrained_ref());
+    get(e.constrained_comment_ref());
+  }
+
+  // Equations and statements
+  void get(Equality &e)
+  {
+    get(e.comment_ref());
+    get(e.left_ref());
+    get(e.right_ref());
+  }
+  void get(Connect &c)
+  {
+    get(c.comment_ref());
+    get(c.left_ref());
+    get(c.right_ref());
+  }
+  void get(CallEq &c)
+  {
+    get(c.comment_ref());
+    get(c.name_ref());
+    get(c.args_ref());
+  }
+  void get(ForEq &f)
+  {
+    get(f.comment_ref());
+    get(f.range_ref());
+    get(f.elements_ref());
+  }
+  void get(IfEq &i)
+  {
+    get(i.comment_ref());
+    getIf(i);
+  }
+  void get(WhenEq &w)
+  {
+    get(w.comment_ref());
+    getWhen(w);
+  }
+  void get(EquationSection &e)
+  {
+    get(e.initial_ref());
+    get(e.equations_ref());
+  }
+  void get(Assign &a)
+  {
+    get(a.left_ref());
+    get(a.right_ref());
+    get(a.rl_ref());
+  }
+  void get(Break &) {}
+  void get(Return &) {}
+  void get(CallSt &c)
+  {
+    get(c.out_ref());
+    get(c.n_ref());
+    get(c.arg_ref());
+  }
+  void get(IfSt &i) { getIf(i); }
+  void get(ForSt &f)
+  {
+    get(f.range_ref());
+    get(f.elements_ref());
+  }
+  void get(WhenSt &w) { getWhen(w); }
+  void get(WhileSt &w)
+  {
+    get(w.cond_ref());
+    get(w.elements_ref());
+  }
+  void get(StatementSection &s)
+  {
+    get(s.initial_ref());
+    get(s.statements_ref());
+  }
+
+  // Classes
+  void get(External &e)
+  {
+    get(e.comp_ref_ref());
+    get(e.fun_ref());
+    get(e.args_ref());
+  }
+  void get(Composition &c)
+  {
+    get(c.elements_ref());
+    get(c.comp_elem_ref());
+    get(c.external_ref());
+    get(c.language_ref());
+    get(c.call_ref());
+    get(c.ext_annot_ref());
+    get(c.annotation_ref());
+  }
+  void get(Class &c)
+  {
+    get(c.name_ref());
+    get(c.st_comment_ref());
+    get(c.composition_ref());
+    get(c.end_name_ref());
+    get(c.prefixes_ref());
+    get(c.final_ref());
+    get(c.encapsulated_ref());
+  }
+  void get(DefClass &c)
+  {
+    get(c.name_ref());
+    get(c.type_prefixes_ref());
+    get(c.definition_ref());
+    get(c.indices_ref());
+    get(c.modification_ref());
+    get(c.comment_ref());
+    get(c.prefixes_ref());
+    get(c.encapsulated_ref());
+    get(c.final_ref());
+  }
+  void get(EnumClass &c)
+  {
+    get(c.name_ref());
+    get(c.enum_spec_ref());
+    get(c.comment_ref());
+    get(c.prefixes_ref());
+    get(c.encapsulated_ref());
+    get(c.final_ref());
+  }
+  void get(DerClass &c)
+  {
+    get(c.name_ref());
+    get(c.deriv_ref());
+    get(c.ident_list_ref());
+    get(c.comment_ref());
+    get(c.prefixes_ref());
+    get(c.encapsulated_ref());
+    get(c.final_ref());
+  }
+  void get(ExtendsClass &c)
+  {
+    get(c.name_ref());
+    get(c.modification_ref());
+    get(c.st_comment_ref());
+    get(c.composition_ref());
+    get(c.prefixes_ref());
+    get(c.encapsulated_ref());
+    get(c.final_ref());
+  }
+  void get(StoredDef &sd)
+  {
+    get(sd.name_ref());
+    get(sd.within_ref());
+    get(sd.classes_ref());
+  }
+
+  private:
+  int enumValue(int last)
+  {
+    int v;
+    get(v);
+    if (v < 0 || v > last) throw Malformed();
+    return v;
+  }
+  template <typename V>
+  void alternative(V &, int)
+  {
+    throw Malformed();
+  }
+  template <typename V, typename T, typename... TN>
+  void alternative(V &v, int which)
+  {
+    if (which != 0) {
+      alternative<V, TN...>(v, which - 1);
+      return;
+    }
+    typename Unwrapped<T>::type t;
+    get(t);
+    v = std::move(t);
+  }
+  template <typename E>
+  void getIf(If<E> &i)
+  {
+    get(i.cond_ref());
+    get(i.elements_ref());
+    get(i.elseif_ref());
+    get(i.ifnot_ref());
+  }
+  template <typename E>
+  void getWhen(When<E> &w)
+  {
+    get(w.cond_ref());
+    get(w.elements_ref());
+    get(w.elsewhen_ref());
+  }
+  const char *next_;
+  const char *end_;
+};
+
+template <typename Node>
+void write(const Node &node, std::string &out)
+{
+  Writer w(out);
+  out.append(MAGIC, sizeof(MAGIC));
+  w.word(SERIAL_VERSION);
+  w(node);
+}
+
+template <typename Node>
+bool read(const char *data, size_t size, Node &node)
+{
+  Reader r(data, size);
+  try {
+    char magic[sizeof(MAGIC)];
+    r.bytes(magic, sizeof(magic));
+    if (memcmp(magic, MAGIC, sizeof(MAGIC)) || r.word() != SERIAL_VERSION) return false;
+    Node parsed;
+    r.get(parsed);
+    if (!r.atEnd()) return false;
+    node = std::move(parsed);
+    return true;
+  } catch (Malformed &) {
+    return false;
+  }
+}
+}  // namespace
+
+void serialize(const StoredDef &sd, std::string &out) { write(sd, out); }
+
+void serialize(const ElemList &elements, std::string &out) { write(elements, out); }
+
+bool deserialize(const char *data, size_t size, StoredDef &sd) { return read(data, size, sd); }
+
+bool deserialize(const char *data, size_t size, ElemList &elements) { return read(data, size, elements); }
+
+}  // namespace AST
+}  // namespace Modelica
@@ -0,0 +1,50 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#ifndef AST_SERIALIZE
+#define AST_SERIALIZE
+#include <cstddef>
+#include <string>
+#include <ast/class.h>
+
+namespace Modelica {
+namespace AST {
+
+/**
+ * A compact binary image of a parsed stored definition, used to cache ASTs
+ * on disk. The image starts with a magic word and SERIAL_VERSION, and is
+ * only meant to be read back by the same build that wrote it: bump the
+ * version whenever an AST node gains, loses or reorders a field or a
+ * variant alternative.
+ */
+const unsigned SERIAL_VERSION = 1;
+
+/// @brief Appends the binary image of sd to out
+void serialize(const StoredDef &sd, std::string &out);
+/// @brief Appends the binary image of a list of class elements to out
+void serialize(const ElemList &elements, std::string &out);
+/// @brief Rebuilds sd from an image. Returns false, leaving sd untouched, if
+/// the data is truncated, malformed or from another SERIAL_VERSION
+bool deserialize(const char *data, size_t size, StoredDef &sd);
+/// @brief Rebuilds a list of class elements from an image, as above
+bool deserialize(const char *data, size_t size, ElemList &elements);
+
+}  // namespace AST
+}  // namespace Modelica
+#endif
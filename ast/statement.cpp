@@ -30,7 +30,7 @@ std::ostream& operator<<(std::ostream& out, const StatementSection& ss)
     out << "algorithm\n";
   }
   BEGIN_BLOCK;
-  foreach_(Statement s, ss.statements()) out << INDENT << s << ";\n";
+  foreach_(const Statement &s, ss.statements()) out << INDENT << s << ";\n";
   END_BLOCK;
   return out;
 }
@@ -94,7 +94,7 @@ std::ostream& operator<<(std::ostream& out, const WhileSt& st)  // output
 {
   out << "while " << st.cond() << " loop\n";
   BEGIN_BLOCK;
-  foreach_(Statement s, st.elements()) { out << INDENT << s << ";\n"; }
+  foreach_(const Statement &s, st.elements()) { out << INDENT << s << ";\n"; }
   END_BLOCK;
   out << INDENT << "end while";
   return out;
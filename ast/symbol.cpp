@@ -0,0 +1,77 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#include <ast/symbol.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace Modelica {
+namespace AST {
+
+namespace {
+// Node based, so the interned strings never move. Each spelling is stored
+// with its hash.
+typedef std::unordered_map<std::string, size_t> Table;
+
+Table &symbolTable()
+{
+  static Table table;
+  return table;
+}
+
+std::mutex &symbolMutex()
+{
+  static std::mutex m;
+  return m;
+}
+
+// Each thread remembers the symbols it has already interned, so the global
+// table (and its lock) is only touched the first time a thread sees a name.
+const Symbol::Entry *intern(const std::string &s)
+{
+  thread_local std::unordered_map<std::string, const Symbol::Entry *> seen;
+  std::unordered_map<std::string, const Symbol::Entry *>::const_iterator it = seen.find(s);
+  if (it != seen.end()) return it->second;
+  const Symbol::Entry *interned;
+  {
+    std::lock_guard<std::mutex> lock(symbolMutex());
+    interned = &*symbolTable().emplace(s, std::hash<std::string>()(s)).first;
+  }
+  seen.emplace(s, interned);
+  return interned;
+}
+}  // namespace
+
+Symbol::Symbol()
+{
+  static const Entry *empty = intern("");
+  entry_ = empty;
+}
+Symbol::Symbol(const std::string &s) : entry_(intern(s)) {}
+Symbol::Symbol(const char *s) : entry_(intern(s)) {}
+
+size_t Symbol::tableSize()
+{
+  std::lock_guard<std::mutex> lock(symbolMutex());
+  return symbolTable().size();
+}
+
+}  // namespace AST
+}  // namespace Modelica
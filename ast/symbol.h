@@ -0,0 +1,97 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#ifndef AST_SYMBOL
+#define AST_SYMBOL
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace Modelica {
+namespace AST {
+
+/**
+ * An interned identifier. Every distinct spelling is stored once in a global
+ * table and a Symbol is a handle to that copy, so equality is a pointer
+ * comparison instead of a string comparison. The hash of the spelling is
+ * computed once, when it is interned, and kept next to it. It depends only
+ * on the characters, so unordered containers keyed by Symbol iterate in the
+ * same order on every run. Interning is thread safe: each thread keeps its
+ * own cache in front of the global table, so only the first sight of a name
+ * on a thread takes the lock. Reading a Symbol never does.
+ *
+ * Symbols convert implicitly from and to std::string so they can be used
+ * wherever a Name is expected. Ordering is lexicographic, as for Names.
+ *
+ * Only the names inside a RefTuple and the keys of VarSymbolTable,
+ * ReplaceMany and PartialEvalExpression are Symbols. Name is still a
+ * std::string, and so are the parser attributes, class and component names,
+ * and the names the other visitors pass around. They are interned where they
+ * meet one of the above.
+ */
+class Symbol {
+  public:
+  Symbol();
+  Symbol(const std::string &s);
+  Symbol(const char *s);
+  const std::string &str() const { return entry_->first; }
+  const char *c_str() const { return entry_->first.c_str(); }
+  size_t size() const { return entry_->first.size(); }
+  bool empty() const { return entry_->first.empty(); }
+  operator const std::string &() const { return entry_->first; }
+  /// @brief Hash of the spelling, the same for equal strings on every run
+  size_t hash() const { return entry_->second; }
+  bool operator==(const Symbol &other) const { return entry_ == other.entry_; }
+  bool operator!=(const Symbol &other) const { return entry_ != other.entry_; }
+  bool operator<(const Symbol &other) const { return entry_ != other.entry_ && entry_->first < other.entry_->first; }
+  /// @brief Number of distinct symbols interned so far
+  static size_t tableSize();
+  /// @brief A spelling in the intern table and its hash
+  typedef std::pair<const std::string, size_t> Entry;
+
+  private:
+  const Entry *entry_;
+};
+
+inline bool operator==(const Symbol &a, const std::string &b) { return a.str() == b; }
+inline bool operator==(const std::string &a, const Symbol &b) { return a == b.str(); }
+inline bool operator==(const Symbol &a, const char *b) { return a.str() == b; }
+inline bool operator!=(const Symbol &a, const std::string &b) { return a.str() != b; }
+inline bool operator!=(const std::string &a, const Symbol &b) { return a != b.str(); }
+inline bool operator!=(const Symbol &a, const char *b) { return a.str() != b; }
+inline std::string operator+(const Symbol &a, const std::string &b) { return a.str() + b; }
+inline std::string operator+(const std::string &a, const Symbol &b) { return a + b.str(); }
+inline std::string operator+(const Symbol &a, const char *b) { return a.str() + b; }
+inline std::string operator+(const char *a, const Symbol &b) { return a + b.str(); }
+inline std::ostream &operator<<(std::ostream &out, const Symbol &s) { return out << s.str(); }
+inline size_t hash_value(const Symbol &s) { return s.hash(); }
+
+}  // namespace AST
+}  // namespace Modelica
+
+namespace std {
+template <>
+struct hash<Modelica::AST::Symbol> {
+  size_t operator()(const Modelica::AST::Symbol &s) const { return hash_value(s); }
+};
+}  // namespace std
+#endif
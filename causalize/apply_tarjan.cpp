@@ -32,7 +32,10 @@
 #include <boost/graph/strong_components.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
+#include <boost/unordered_map.hpp>
+
 #include <map>
+#include <vector>
 #include <stdio.h>
 
 namespace Causalize {
@@ -40,45 +43,115 @@ typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS> Direct
 typedef boost::graph_traits<DirectedGraph>::vertex_descriptor DGVertex;
 typedef boost::graph_traits<DirectedGraph>::edge_descriptor DGEdge;
 
-std::map<Vertex, Vertex> _matching;
-std::map<DGVertex, Vertex> _collapsed2original;
-using namespace Causalize;
+/// @brief Dense index of the vertices of the causalization graph. Since the
+/// causalization graph uses listS, vertices are numbered once here and all the
+/// auxiliary maps are plain vectors indexed by this number.
+typedef boost::unordered_map<Vertex, int> VertexIndex;
+typedef boost::associative_property_map<VertexIndex> VertexIndexMap;
+typedef boost::iterator_property_map<std::vector<Vertex>::iterator, VertexIndexMap> MatchingMap;
+
+/// @brief Bidirectional mapping between equation vertices of the causalization
+/// graph and vertices of the collapsed digraph. Both directions are O(1).
+struct CollapsedIndex {
+  /// @brief Indexed by collapsed vertex (vecS)
+  std::vector<Vertex> collapsed2original;
+  /// @brief Indexed by the dense index of the original vertex, -1 for unknowns
+  std::vector<int> original2collapsed;
+};
+
+/// @brief Initial matching for the maximum cardinality matching, following
+/// the Karp-Sipser heuristic: vertices with only one free neighbour are matched
+/// first, and only when none is left an arbitrary free edge is taken. On
+/// causalization graphs this usually yields a perfect matching in O(V + E),
+/// leaving (almost) no work to the augmenting path finder, which costs O(V)
+/// per augmentation.
+template <typename Graph, typename MateMap>
+struct karp_sipser_matching {
+  typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
+  typedef typename boost::graph_traits<Graph>::vertex_iterator vertex_iterator_t;
+  typedef typename boost::graph_traits<Graph>::adjacency_iterator adjacency_iterator_t;
+
+  static bool isFree(MateMap mate, vertex_t v) { return get(mate, v) == boost::graph_traits<Graph>::null_vertex(); }
+
+  static void match(const Graph &g, MateMap mate, vertex_t v, vertex_t u, boost::unordered_map<vertex_t, int> &degree,
+                    std::vector<vertex_t> &degree1)
+  {
+    put(mate, v, u);
+    put(mate, u, v);
+    adjacency_iterator_t ai, ai_end;
+    for (int k = 0; k < 2; k++) {
+      for (boost::tie(ai, ai_end) = adjacent_vertices(k == 0 ? v : u, g); ai != ai_end; ++ai) {
+        if (isFree(mate, *ai) && --degree[*ai] == 1) degree1.push_back(*ai);
+      }
+    }
+  }
 
-DGVertex original2collapsed(Vertex value)
-{
-  std::map<DGVertex, Vertex>::iterator it;
-  for (it = _collapsed2original.begin(); it != _collapsed2original.end(); it++) {
-    if ((*it).second == value) {
-      return (*it).first;
+  static bool matchAny(const Graph &g, MateMap mate, vertex_t v, boost::unordered_map<vertex_t, int> &degree,
+                       std::vector<vertex_t> &degree1)
+  {
+    adjacency_iterator_t ai, ai_end;
+    for (boost::tie(ai, ai_end) = adjacent_vertices(v, g); ai != ai_end; ++ai) {
+      if (isFree(mate, *ai)) {
+        match(g, mate, v, *ai, degree, degree1);
+        return true;
+      }
     }
+    return false;
   }
-  ERROR("Can't find collapsed vertex from original.");
-  return (*it).first;
-}
 
-void buildCollapsedGraph(Causalize::CausalizationGraph &graph, DirectedGraph &digraph)
+  static void find_matching(const Graph &g, MateMap mate)
+  {
+    boost::unordered_map<vertex_t, int> degree;
+    std::vector<vertex_t> degree1;
+    vertex_iterator_t vi, vi_end;
+    for (boost::tie(vi, vi_end) = vertices(g); vi != vi_end; ++vi) {
+      put(mate, *vi, boost::graph_traits<Graph>::null_vertex());
+      degree[*vi] = out_degree(*vi, g);
+      if (degree[*vi] == 1) degree1.push_back(*vi);
+    }
+    for (boost::tie(vi, vi_end) = vertices(g); vi != vi_end;) {
+      if (!degree1.empty()) {
+        vertex_t v = degree1.back();
+        degree1.pop_back();
+        if (isFree(mate, v)) matchAny(g, mate, v, degree, degree1);
+      } else {
+        if (isFree(mate, *vi)) matchAny(g, mate, *vi, degree, degree1);
+        ++vi;
+      }
+    }
+  }
+};
+
+void buildCollapsedGraph(CausalizationGraph &graph, VertexIndex &vertex2index, std::vector<Vertex> &matching,
+                         CollapsedIndex &collapsed, DirectedGraph &digraph)
 {
-  // Create the vertices on the directed graph
-  Causalize::CausalizationGraph::vertex_iterator vi, vi_end;
+  // Number the equation vertices of the directed graph
+  collapsed.original2collapsed.assign(num_vertices(graph), -1);
+  CausalizationGraph::vertex_iterator vi, vi_end;
   for (boost::tie(vi, vi_end) = vertices(graph); vi != vi_end; ++vi) {
     if (graph[*vi].type == E) {
-      DGVertex v = add_vertex(digraph);
-      _collapsed2original[v] = *vi;
+      collapsed.original2collapsed[vertex2index[*vi]] = collapsed.collapsed2original.size();
+      collapsed.collapsed2original.push_back(*vi);
     }
   }
-  // Create the edges on the directed graph
-  DirectedGraph::vertex_iterator vj, vj_end;
-  for (boost::tie(vj, vj_end) = vertices(digraph); vj != vj_end; ++vj) {
+  // Collect the edges of the directed graph. There can not be more of them
+  // than edges in the causalization graph.
+  std::vector<std::pair<int, int>> edges;
+  edges.reserve(num_edges(graph));
+  for (size_t dgv = 0; dgv < collapsed.collapsed2original.size(); ++dgv) {
     CausalizationGraph::out_edge_iterator ek, ek_end;
-    Vertex originalEqVertex = _collapsed2original[*vj];
-    Vertex uMatchingVertex = _matching[originalEqVertex];
+    Vertex originalEqVertex = collapsed.collapsed2original[dgv];
+    Vertex uMatchingVertex = matching[vertex2index[originalEqVertex]];
     for (boost::tie(ek, ek_end) = out_edges(uMatchingVertex, graph); ek != ek_end; ++ek) {
       Vertex eqAdjacentVertex = target(*ek, graph);
       if (eqAdjacentVertex != originalEqVertex) {
-        boost::add_edge(original2collapsed(eqAdjacentVertex), *vj, digraph);
+        int adjacent = collapsed.original2collapsed[vertex2index[eqAdjacentVertex]];
+        ERROR_UNLESS(adjacent >= 0, "Can't find collapsed vertex from original.");
+        edges.push_back(std::make_pair(adjacent, dgv));
       }
     }
   }
+  digraph = DirectedGraph(edges.begin(), edges.end(), collapsed.collapsed2original.size());
 }
 
 // void replaceMMOClassEquations(MMO_Class mmoClass, MMO_EquationList causalEqs) {
@@ -96,72 +169,59 @@ void buildCollapsedGraph(Causalize::CausalizationGraph &graph, DirectedGraph &di
 
 int apply_tarjan(CausalizationGraph &graph, std::map<int, Causalize::ComponentPtr> &components)
 {
-  boost::associative_property_map<std::map<Vertex, Vertex>> matching_map(_matching);
-
   // Vertex Index Map required for checked_edmonds_maximum_cardinality_matching.
   // This is to allow the causalization graph, which is an adjacency list, to
   // use as VertexList either vecS or listS.
-  std::map<Vertex, int> vertex2index;
+  VertexIndex vertex2index;
   CausalizationGraph::vertex_iterator i, iend;
   int ic = 0;
   for (boost::tie(i, iend) = vertices(graph); i != iend; ++i, ++ic) {
     vertex2index[*i] = ic;
   }
-  boost::associative_property_map<std::map<Vertex, int>> index_map(vertex2index);
+  VertexIndexMap index_map(vertex2index);
+
+  std::vector<Vertex> matching(num_vertices(graph));
+  MatchingMap matching_map(matching.begin(), index_map);
 
   DEBUG('c', "Calculating maximum cardinality matching over causalization graph...\n");
 
-  bool success = checked_edmonds_maximum_cardinality_matching(graph, matching_map, index_map);
+  bool success = boost::matching<CausalizationGraph, MatchingMap, VertexIndexMap, boost::edmonds_augmenting_path_finder, karp_sipser_matching,
+                                 boost::maximum_cardinality_matching_verifier>(graph, matching_map, index_map);
   if (!success) {
     ERROR("Can't find a maximum cardinality matching.\n");
   }
 
-  for (std::map<Vertex, Vertex>::iterator it = _matching.begin(); it != _matching.end(); ++it) {
-    char se[10];
-    Vertex v1 = it->first;
-    if (graph[v1].type == E) {
-      sprintf(se, "E%d", vertex2index[v1]);
-    } else {
-      sprintf(se, "U%d", vertex2index[v1]);
-    }
-    char su[10];
-    Vertex v2 = it->second;
-    if (graph[v2].type == E) {
-      sprintf(su, "E%d", vertex2index[v2]);
-    } else {
-      sprintf(su, "U%d", vertex2index[v2]);
+  if (debugIsEnabled('c')) {
+    for (boost::tie(i, iend) = vertices(graph); i != iend; ++i) {
+      Vertex v1 = *i;
+      Vertex v2 = matching[vertex2index[v1]];
+      if (v2 == boost::graph_traits<CausalizationGraph>::null_vertex()) continue;
+      DEBUG('c', "%c%d matches %c%d\n", graph[v1].type == E ? 'E' : 'U', vertex2index[v1], graph[v2].type == E ? 'E' : 'U',
+            vertex2index[v2]);
     }
-    DEBUG('c', "%s matches %s\n", se, su);
   }
 
   DirectedGraph collapsedGraph;
+  CollapsedIndex collapsed;
 
   DEBUG('c', "Collapsing matching vertices...\n");
 
-  buildCollapsedGraph(graph, collapsedGraph);
+  buildCollapsedGraph(graph, vertex2index, matching, collapsed, collapsedGraph);
 
-  std::map<DGVertex, int> vertex2component;
-  boost::associative_property_map<std::map<DGVertex, int>> component_map(vertex2component);
-  std::map<DGVertex, int> dg_vertex2index;
-  DirectedGraph::vertex_iterator j, jend;
-  int jc = 0;
-  for (boost::tie(j, jend) = vertices(collapsedGraph); j != jend; ++j, ++jc) {
-    dg_vertex2index[*j] = jc;
-  }
-  boost::associative_property_map<std::map<DGVertex, int>> dg_index_map(dg_vertex2index);
+  std::vector<int> vertex2component(num_vertices(collapsedGraph));
 
   DEBUG('c', "Running tarjan algorithm over collapsed graph...\n");
 
-  int numComponents = strong_components(collapsedGraph, component_map, boost::vertex_index_map(dg_index_map));
+  int numComponents = strong_components(
+      collapsedGraph, boost::make_iterator_property_map(vertex2component.begin(), get(boost::vertex_index, collapsedGraph)));
 
   DEBUG('c', "%d strong components identifed.\n", numComponents);
 
-  for (std::map<DGVertex, int>::iterator it = vertex2component.begin(); it != vertex2component.end(); ++it) {
-    DGVertex dgVertex = it->first;
-    int componentIndex = it->second;
-    DEBUG('c', "Vertex: %d -- Component: %d\n", dg_vertex2index[dgVertex], componentIndex);
-    Vertex eqVertex = _collapsed2original[dgVertex];
-    Vertex uVertex = _matching[eqVertex];
+  for (size_t dgVertex = 0; dgVertex < vertex2component.size(); ++dgVertex) {
+    int componentIndex = vertex2component[dgVertex];
+    DEBUG('c', "Vertex: %d -- Component: %d\n", (int)dgVertex, componentIndex);
+    Vertex eqVertex = collapsed.collapsed2original[dgVertex];
+    Vertex uVertex = matching[vertex2index[eqVertex]];
     std::map<int, Causalize::ComponentPtr>::iterator componentsIt = components.find(componentIndex);
     if (componentsIt == components.end()) {
       Causalize::ComponentPtr component = new Causalize::Component;
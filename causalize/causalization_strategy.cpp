@@ -39,13 +39,14 @@
 #include <util/ast_visitors/contains_expression.h>
 #include <util/ast_visitors/partial_eval_expression.h>
 #include <util/solve/solve.h>
+#include <util/thread_pool.h>
 #include <fstream>
 
 using namespace Modelica::AST;
 namespace Causalize {
-CausalizationStrategy::CausalizationStrategy(MMO_Class &mmo_class) : _mmo_class(mmo_class)
+CausalizationStrategy::CausalizationStrategy(MMO_Class &mmo_class, int jobs) : _mmo_class(mmo_class), _fsolve(1), _jobs(jobs), _templates(mmo_class.syms_ref())
 {
-  Causalize::process_for_equations(mmo_class);
+  Causalize::process_for_equations(mmo_class, &_templates.templates());
 
   const EquationList &equations = mmo_class.equations_ref().equations_ref();
 
@@ -69,13 +70,13 @@ CausalizationStrategy::CausalizationStrategy(MMO_Class &mmo_class) : _mmo_class(
   DEBUG('c', "Building causalization graph...\n");
   DEBUG('c', "Equation indexes:\n");
 
+  PartialEvalExpression eval(_mmo_class.syms_ref(), false);
   foreach_(Equation e, equations)
   {
     VertexProperty vp;
     Equality &eq = get<Equality>(e);
-    PartialEvalExpression eval(_mmo_class.syms_ref(), false);
-    eq.left_ref() = Apply(eval, eq.left_ref());
-    eq.right_ref() = Apply(eval, eq.right_ref());
+    eval.simplify(eq.left_ref());
+    eval.simplify(eq.right_ref());
     vp.equation = e;
     vp.type = E;
     vp.index = index++;
@@ -246,7 +247,7 @@ void CausalizationStrategy::SimpleCausalizationStrategy()
       Vertex eq = *eqIter;
       Edge e = GetUniqueEdge(eq);
       Vertex unknown = target(e, _graph);
-      MakeCausalBegining(_graph[eq].equation, _graph[unknown].unknown());
+      MakeCausalBegining(_graph[eq].equation, _graph[unknown].unknown(), _graph[eq].index);
       remove_edge(e, _graph);
       remove_vertex(eq, _graph);
       CollectDegree1Verts(unknown, eqDegree1Verts);
@@ -259,7 +260,7 @@ void CausalizationStrategy::SimpleCausalizationStrategy()
       Vertex unknown = *unknownIter;
       Edge e = GetUniqueEdge(unknown);
       Vertex eq = target(e, _graph);
-      MakeCausalEnd(_graph[eq].equation, _graph[unknown].unknown());
+      MakeCausalEnd(_graph[eq].equation, _graph[unknown].unknown(), _graph[eq].index);
       remove_edge(e, _graph);
       remove_vertex(unknown, _graph);
       CollectDegree1Verts(eq, unknownDegree1Verts);
@@ -294,7 +295,7 @@ void CausalizationStrategy::CollectDegree1Verts(Vertex v, std::list<Vertex> &deg
   }
 }
 
-void CausalizationStrategy::MakeCausalBegining(Equation e, Expression unknown)
+void CausalizationStrategy::MakeCausalBegining(Equation e, Expression unknown, int index)
 {
   if (debugIsEnabled('c')) {
     cout << "MakeCausalBegining" << endl;
@@ -305,13 +306,10 @@ void CausalizationStrategy::MakeCausalBegining(Equation e, Expression unknown)
     cout << std::endl << e;
     cout << std::endl;
   }
-  std::stringstream s;
-  s << _mmo_class.name() << ".c";
-  Equation causalEq = EquationSolver::Solve(e, unknown, _mmo_class.syms_ref(), c_code, _cl, s.str());
-  _causalEqsBegining.push_back(causalEq);
+  _causalEqsBegining.push_back(SolveEquation(e, unknown, index));
 }
 
-void CausalizationStrategy::MakeCausalEnd(Equation e, Expression unknown)
+void CausalizationStrategy::MakeCausalEnd(Equation e, Expression unknown, int index)
 {
   if (debugIsEnabled('c')) {
     cout << "MakeCausalEnd" << endl;
@@ -322,10 +320,20 @@ void CausalizationStrategy::MakeCausalEnd(Equation e, Expression unknown)
     cout << std::endl << e;
     cout << std::endl;
   }
+  _causalEqsEnd[_causalEqsEndIndex--] = SolveEquation(e, unknown, index);
+}
+
+/**
+ * Equations unrolled from a for loop are solved through the (cached) solution
+ * of the loop body when possible.
+ */
+Equation CausalizationStrategy::SolveEquation(Equation e, Expression unknown, int index)
+{
+  Equation causalEq;
+  if (_templates.Solve(index, unknown, causalEq)) return causalEq;
   std::stringstream s;
   s << _mmo_class.name() << ".c";
-  Equation causalEq = EquationSolver::Solve(e, unknown, _mmo_class.syms_ref(), c_code, _cl, s.str());
-  _causalEqsEnd[_causalEqsEndIndex--] = causalEq;
+  return EquationSolver::Solve(e, unknown, _mmo_class.syms_ref(), c_code, _cl, s.str(), _fsolve);
 }
 
 /**
@@ -337,31 +345,51 @@ void CausalizationStrategy::MakeCausalMiddle()
 
   int n_comps = apply_tarjan(_graph, components);
 
+  std::vector<EquationList> blockEqs(n_comps);
+  std::vector<ExpList> blockUnknowns(n_comps);
+  std::vector<EquationList> blockCausalEqs(n_comps);
+  std::vector<char> blockSolved(n_comps);
   for (int i = 0; i < n_comps; i++) {
     ComponentPtr component = components[i];
 
     std::list<Vertex> *uVertices = component->uVertices;
-    ExpList unknowns;
     std::list<Vertex>::iterator uIt;
     for (uIt = uVertices->begin(); uIt != uVertices->end(); uIt++) {
       Vertex v = *uIt;
       Expression unknown = _graph[v].unknown();
-      unknowns.push_back(unknown);
+      blockUnknowns[i].push_back(unknown);
     }
 
     std::list<Vertex> *eqVertices = component->eqVertices;
-    EquationList eqs;
     std::list<Vertex>::iterator eqIt;
     for (eqIt = eqVertices->begin(); eqIt != eqVertices->end(); eqIt++) {
       Vertex v = *eqIt;
       Equation eq = _graph[v].equation;
-      eqs.push_back(eq);
+      blockEqs[i].push_back(eq);
     }
 
-    std::stringstream s;
-    s << _mmo_class.name() << ".c";
-    EquationList causalEqs = EquationSolver::Solve(eqs, unknowns, _mmo_class.syms_ref(), c_code, _cl, s.str());
-    _causalEqsMiddle.insert(_causalEqsMiddle.end(), causalEqs.begin(), causalEqs.end());
+    Equation causalEq;
+    if (eqVertices->size() == 1 && _templates.Solve(_graph[eqVertices->front()].index, blockUnknowns[i].front(), causalEq)) {
+      blockCausalEqs[i].push_back(causalEq);
+      blockSolved[i] = true;
+    }
+  }
+
+  // Blocks are independent once sorted, so the symbolic solving is done in
+  // parallel. Non-linear blocks are left for the assembly below so that the
+  // fsolveN functions are numbered in block order.
+  DEBUG('c', "Solving %d blocks using %d threads\n", n_comps, _jobs);
+  parallelFor(n_comps, _jobs, [&](size_t i) {
+    if (!blockSolved[i]) blockSolved[i] = EquationSolver::SolveLinear(blockEqs[i], blockUnknowns[i], _mmo_class.syms_ref(), blockCausalEqs[i]);
+  });
+
+  std::stringstream s;
+  s << _mmo_class.name() << ".c";
+  for (int i = 0; i < n_comps; i++) {
+    if (!blockSolved[i]) {
+      blockCausalEqs[i] = EquationSolver::SolveNonLinear(blockEqs[i], blockUnknowns[i], _mmo_class.syms_ref(), c_code, _cl, s.str(), _fsolve);
+    }
+    _causalEqsMiddle.insert(_causalEqsMiddle.end(), blockCausalEqs[i].begin(), blockCausalEqs[i].end());
   }
 }
 }  // namespace Causalize
@@ -25,12 +25,14 @@
  */
 
 #include <causalize/graph/graph_definition.h>
+#include <causalize/for_unrolling/template_solver.h>
 #include <mmo/mmo_class.h>
 
 namespace Causalize {
 class CausalizationStrategy {
   public:
-  CausalizationStrategy(Modelica::MMO_Class &mmo_class);
+  /// @param jobs Maximum number of threads used to solve the strongly connected components
+  CausalizationStrategy(Modelica::MMO_Class &mmo_class, int jobs = 1);
   void Causalize();
   void CausalizeSimple();
   void CausalizeTarjan();
@@ -39,9 +41,10 @@ class CausalizationStrategy {
   void SimpleCausalizationStrategy();
   Edge GetUniqueEdge(Vertex v);
   void CollectDegree1Verts(Vertex v, std::list<Vertex> &degree1Verts);
-  void MakeCausalBegining(Modelica::AST::Equation eq, Modelica::AST::Expression unknown);
+  void MakeCausalBegining(Modelica::AST::Equation eq, Modelica::AST::Expression unknown, int index);
   void MakeCausalMiddle();
-  void MakeCausalEnd(Modelica::AST::Equation eq, Modelica::AST::Expression unknown);
+  void MakeCausalEnd(Modelica::AST::Equation eq, Modelica::AST::Expression unknown, int index);
+  Modelica::AST::Equation SolveEquation(Modelica::AST::Equation eq, Modelica::AST::Expression unknown, int index);
 
   CausalizationGraph _graph;
   Modelica::MMO_Class &_mmo_class;
@@ -52,5 +55,8 @@ class CausalizationStrategy {
   Modelica::AST::ClassList _cl;
   Modelica::AST::ExpList _all_unknowns;
   std::list<std::string> c_code;
+  int _fsolve;
+  int _jobs;
+  TemplateSolver _templates;
 };
 }  // namespace Causalize
@@ -25,7 +25,7 @@
 
 namespace Causalize {
 
-RangeIterator::RangeIterator(Range range, VarSymbolTable symbolTable)
+RangeIterator::RangeIterator(Range range, const VarSymbolTable &symbolTable)
 {
   _rangeBegin = eval(range.start(), symbolTable);
   _rangeEnd = eval(range.end(), symbolTable);
@@ -36,7 +36,7 @@ RangeIterator::RangeIterator(Range range, VarSymbolTable symbolTable)
   _current = _rangeBegin;
 }
 
-Real RangeIterator::eval(Expression exp, VarSymbolTable symbolTable) { return Apply(Modelica::EvalExpression(symbolTable), exp); }
+Real RangeIterator::eval(Expression exp, const VarSymbolTable &symbolTable) { return Apply(Modelica::EvalExpression(symbolTable), exp); }
 
 bool RangeIterator::hasNext() { return _current <= _rangeEnd; }
 
@@ -31,14 +31,14 @@ class ForIndexIterator {
 
 class RangeIterator : public ForIndexIterator {
   public:
-  RangeIterator(Range range, VarSymbolTable symbolTable);
+  RangeIterator(Range range, const VarSymbolTable &symbolTable);
   bool hasNext();
   Real next();
   Real begin() { return _rangeBegin; };
   Real end() { return _rangeEnd; }
 
   private:
-  Real eval(Expression exp, VarSymbolTable symbolTable);
+  Real eval(Expression exp, const VarSymbolTable &symbolTable);
   ExpList _rangeElements;
   Real _rangeBegin;
   Real _rangeStep;
@@ -24,6 +24,7 @@
 #include <util/debug.h>
 #include <util/table.h>
 #include <util/ast_visitors/partial_eval_expression.h>
+#include <util/ast_visitors/replace_many.h>
 
 #include <causalize/for_unrolling/process_for_equations.h>
 #include <causalize/for_unrolling/for_index_iterator.h>
@@ -32,14 +33,24 @@ namespace Causalize {
 
 Equation instantiate_equation(Equation innerEq, Name variable, Real index, VarSymbolTable &symbolTable)
 {
-  VarSymbolTable v = symbolTable;
-  VarInfo vinfo = VarInfo(TypePrefixes(1, parameter), "Integer", Option<Comment>(), Modification(ModEq(Expression(index))));
-  v.insert(variable, vinfo);
+  Modelica::PartialEvalExpression eval(symbolTable);
+  return instantiate_equation(innerEq, variable, index, eval);
+}
+
+Expression instantiate_expression(const Expression &exp, Name variable, Real index, const Modelica::PartialEvalExpression &eval)
+{
+  const int i = index;
+  Modelica::ReplaceMap value;
+  value[variable] = (i == index ? Expression(i) : Expression(index));
+  Modelica::ReplaceMany replace(value);
+  return Apply(eval, Apply(replace, exp));
+}
+
+Equation instantiate_equation(const Equation &innerEq, Name variable, Real index, const Modelica::PartialEvalExpression &eval)
+{
   if (is<Equality>(innerEq)) {
-    Equality eqeq = boost::get<Equality>(innerEq);
-    Expression l = eqeq.left(), r = eqeq.right();
-    // std::cout << "Left= " << l << " right " << r << std::endl;
-    return Equality(Apply(Modelica::PartialEvalExpression(v), l), Apply(Modelica::PartialEvalExpression(v), r));
+    const Equality &eqeq = boost::get<Equality>(innerEq);
+    return Equality(instantiate_expression(eqeq.left(), variable, index, eval), instantiate_expression(eqeq.right(), variable, index, eval));
   } else {
     ERROR(
         "process_for_equations - instantiate_equation:\n"
@@ -48,7 +59,7 @@ Equation instantiate_equation(Equation innerEq, Name variable, Real index, VarSy
   return Equation();
 }
 
-void process_for_equations(Modelica::MMO_Class &mmo_class)
+void process_for_equations(Modelica::MMO_Class &mmo_class, ForTemplates *templates)
 {
   EquationList &equations = mmo_class.equations_ref().equations_ref();
   EquationList new_equations;
@@ -73,14 +84,23 @@ void process_for_equations(Modelica::MMO_Class &mmo_class)
       } else {
         ERROR("For Iterator not supported");
       }
+      Modelica::PartialEvalExpression eval(mmo_class.syms_ref());
+      int body = templates ? templates->bodies.size() : -1;
+      if (templates) templates->bodies.insert(templates->bodies.end(), feq.elements().begin(), feq.elements().end());
       while (forIndexIter->hasNext()) {
         Real index_val = forIndexIter->next();
-        foreach_(Equation eq, feq.elements()) new_equations.push_back(instantiate_equation(eq, variable, index_val, mmo_class.syms_ref()));
+        int b = body;
+        foreach_(Equation eq, feq.elements())
+        {
+          new_equations.push_back(instantiate_equation(eq, variable, index_val, eval));
+          if (templates) templates->instances.push_back(ForInstance(b++, variable, index_val));
+        }
       }
       delete forIndexIter;
     } else {
       // Not a for eq
       new_equations.push_back(e);
+      if (templates) templates->instances.push_back(ForInstance());
     }
   }
   mmo_class.equations_ref().equations_ref() = new_equations;
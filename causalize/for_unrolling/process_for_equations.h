@@ -17,7 +17,12 @@
 
 ******************************************************************************/
 
+#ifndef PROCESS_FOR_EQUATIONS_H_
+#define PROCESS_FOR_EQUATIONS_H_
+
+#include <vector>
 #include <mmo/mmo_class.h>
+#include <util/ast_visitors/partial_eval_expression.h>
 
 /**
  * Performs a loop unrolling over the for-equations
@@ -25,6 +30,30 @@
  */
 
 namespace Causalize {
-void process_for_equations(Modelica::MMO_Class &mmo_class);
+/// @brief Origin of an equation produced by process_for_equations
+struct ForInstance {
+  ForInstance() : body(-1), index(0){};
+  ForInstance(int b, Name v, Real i) : body(b), variable(v), index(i){};
+  /// @brief Position of the for-equation body in ForTemplates::bodies, -1 if the equation is not unrolled from a for loop
+  int body;
+  Name variable;
+  Real index;
+};
+
+/// @brief The bodies of the unrolled for-equations, and for each resulting
+/// equation (in order) the body and index value it was instantiated with.
+struct ForTemplates {
+  EquationList bodies;
+  std::vector<ForInstance> instances;
+};
+
+void process_for_equations(Modelica::MMO_Class &mmo_class, ForTemplates *templates = NULL);
 Equation instantiate_equation(Equation, Name, Real, VarSymbolTable &);
+/// @brief Binds the index variable to its value in a single substitution pass
+/// and folds the result with an evaluator shared across the loop iterations.
+Equation instantiate_equation(const Equation &, Name, Real, const Modelica::PartialEvalExpression &);
+/// @brief The same for a single expression
+Expression instantiate_expression(const Expression &, Name, Real, const Modelica::PartialEvalExpression &);
 }  // namespace Causalize
+
+#endif /* PROCESS_FOR_EQUATIONS_H_ */
@@ -0,0 +1,168 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#include <algorithm>
+#include <boost/variant/get.hpp>
+#include <boost/variant/static_visitor.hpp>
+
+#include <causalize/for_unrolling/template_solver.h>
+#include <util/ast_visitors/contains_expression.h>
+#include <util/ast_visitors/partial_eval_expression.h>
+#include <util/debug.h>
+#include <util/solve/solve.h>
+
+namespace Causalize {
+
+/// @brief Collects the references of a for-equation body, and whether it
+/// only uses constructions the template solving path handles.
+class CollectReferences : public boost::static_visitor<void> {
+  public:
+  CollectReferences(ExpList &refs) : refs(refs), supported(true){};
+  void operator()(Integer) const {}
+  void operator()(Real) const {}
+  void operator()(BinOp v) const
+  {
+    ApplyThis(v.left_ref());
+    ApplyThis(v.right_ref());
+  }
+  void operator()(UnaryOp v) const { ApplyThis(v.exp_ref()); }
+  void operator()(Output v) const
+  {
+    foreach_(OptExp oe, v.args()) if (oe) ApplyThis(oe.get());
+  }
+  void operator()(Call v) const
+  {
+    if (v.name() == "der") add(v);
+    foreach_(Expression e, v.args()) ApplyThis(e);
+  }
+  void operator()(Reference v) const
+  {
+    if (v.ref().size() != 1) {
+      supported = false;
+      return;
+    }
+    Option<ExpList> oel = get<1>(v.ref().front());
+    if (oel && oel.get().size() > 1) supported = false;
+    add(v);
+  }
+  template <typename T>
+  void operator()(T) const
+  {
+    supported = false;
+  }
+  void add(Expression e) const
+  {
+    if (std::find(refs.begin(), refs.end(), e) == refs.end()) refs.push_back(e);
+  }
+  ExpList &refs;
+  mutable bool supported;
+};
+
+/// @brief Name of the variable referenced by x or der(x)
+static Option<Name> variableName(Expression e)
+{
+  if (is<Call>(e)) {
+    Call c = get<Call>(e);
+    if (c.name() != "der" || c.args().size() != 1) return Option<Name>();
+    e = c.args().front();
+  }
+  if (!is<Reference>(e)) return Option<Name>();
+  return get<0>(get<Reference>(e).ref().front()).str();
+}
+
+static bool hasSubscripts(Expression e)
+{
+  if (is<Call>(e)) e = Expression(get<Call>(e).args().front());
+  return get<1>(get<Reference>(e).ref().front()).size() > 0;
+}
+
+TemplateSolver::TemplateSolver(VarSymbolTable &syms) : _syms(syms), _eval(syms) {}
+
+ForTemplates &TemplateSolver::templates() { return _templates; }
+
+void TemplateSolver::analyze(int body)
+{
+  if (_bodies.size() < _templates.bodies.size()) _bodies.resize(_templates.bodies.size());
+  Body &b = _bodies[body];
+  if (b.analyzed) return;
+  b.analyzed = true;
+  Equation eq = _templates.bodies[body];
+  if (!is<Equality>(eq)) return;
+  Equality &eqeq = get<Equality>(eq);
+  CollectReferences collect(b.occurrences);
+  Apply(collect, eqeq.left_ref());
+  Apply(collect, eqeq.right_ref());
+  if (!collect.supported) return;
+  // The symbolic solution is valid for every index only if the coefficients
+  // do not depend on the loop variable, i.e. it only appears in subscripts.
+  Name variable;
+  foreach_(ForInstance fi, _templates.instances)
+  {
+    if (fi.body == body) {
+      variable = fi.variable;
+      break;
+    }
+  }
+  Expression loopVariable = Reference(variable);
+  Modelica::ContainsExpression index(loopVariable);
+  b.indexFree = !Apply(index, eqeq.left_ref()) && !Apply(index, eqeq.right_ref());
+}
+
+bool TemplateSolver::Solve(int eq, Expression unknown, Equation &causal)
+{
+  if (eq < 0 || eq >= (int)_templates.instances.size()) return false;
+  ForInstance fi = _templates.instances[eq];
+  if (fi.body < 0) return false;
+  analyze(fi.body);
+  Body &b = _bodies[fi.body];
+  Option<Name> name = variableName(unknown);
+  if (!b.indexFree || !name) return false;
+
+  // Find the only reference in the body that becomes the unknown for this
+  // index. If two different references alias it the body can not be used.
+  int occurrence = -1;
+  for (size_t i = 0; i < b.occurrences.size(); i++) {
+    Expression occ = b.occurrences[i];
+    if (variableName(occ) != name) continue;
+    if (!hasSubscripts(occ)) return false;
+    if (instantiate_expression(occ, fi.variable, fi.index, _eval) == unknown) {
+      if (occurrence >= 0) return false;
+      occurrence = i;
+    }
+  }
+  if (occurrence < 0) return false;
+
+  std::pair<int, int> key(fi.body, occurrence);
+  std::map<std::pair<int, int>, Option<Equality>>::iterator it = _solved.find(key);
+  if (it == _solved.end()) {
+    EquationList solved;
+    Option<Equality> res;
+    if (EquationSolver::SolveLinear(EquationList(1, _templates.bodies[fi.body]), ExpList(1, b.occurrences[occurrence]), _syms, solved) &&
+        solved.size() == 1 && is<Equality>(solved.front())) {
+      res = Equality(b.occurrences[occurrence], get<Equality>(solved.front()).right());
+      DEBUG('c', "Template solution for body %d, occurrence %d found\n", fi.body, occurrence);
+    }
+    it = _solved.insert(std::make_pair(key, res)).first;
+  }
+  if (!it->second) return false;
+  causal = instantiate_equation(it->second.get(), fi.variable, fi.index, _eval);
+  return true;
+}
+}  // namespace Causalize
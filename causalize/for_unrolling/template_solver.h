@@ -0,0 +1,69 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#ifndef TEMPLATE_SOLVER_H_
+#define TEMPLATE_SOLVER_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+#include <causalize/for_unrolling/process_for_equations.h>
+
+namespace Causalize {
+/**
+ * Solves the equations unrolled from a for-equation by solving the body of
+ * the loop once, with the loop variable as a symbol, and then instantiating
+ * the symbolic solution for each index value. This way the symbolic solver
+ * runs once per (body, unknown) pair instead of once per iteration.
+ */
+class TemplateSolver {
+  public:
+  TemplateSolver(VarSymbolTable &syms);
+  ForTemplates &templates();
+  /**
+   * Tries to solve the equation number eq (as produced by process_for_equations)
+   * for unknown through its for-equation body. Returns false if the equation does
+   * not come from a for loop or if the body can not be solved symbolically for
+   * every index, in which case the equation must be solved on its own.
+   */
+  bool Solve(int eq, Expression unknown, Equation &causal);
+
+  private:
+  struct Body {
+    Body() : analyzed(false), indexFree(false){};
+    bool analyzed;
+    /// @brief The loop variable only appears inside subscripts
+    bool indexFree;
+    /// @brief Subscripted references (and their derivatives) in the body
+    ExpList occurrences;
+  };
+  void analyze(int body);
+
+  ForTemplates _templates;
+  std::vector<Body> _bodies;
+  /// @brief Solved bodies indexed by (body, occurrence). Unsolvable ones are empty.
+  std::map<std::pair<int, int>, Option<Equality>> _solved;
+  VarSymbolTable &_syms;
+  /// @brief Folds the instances of the bodies, shared by every index
+  Modelica::PartialEvalExpression _eval;
+};
+}  // namespace Causalize
+
+#endif /* TEMPLATE_SOLVER_H_ */
@@ -44,8 +44,9 @@ int main(int argc, char **argv)
   bool r;
   int opt;
   bool vectorial = false;
+  int jobs = 1;
 
-  while ((opt = getopt(argc, argv, "d:v")) != -1) {
+  while ((opt = getopt(argc, argv, "d:vj:")) != -1) {
     switch (opt) {
     case 'd':
       if (optarg != NULL && isDebugParam(optarg)) {
@@ -57,6 +58,10 @@ int main(int argc, char **argv)
     case 'v':
       vectorial = true;
       break;
+    case 'j':
+      jobs = atoi(optarg);
+      if (jobs < 1) ERROR("command-line option j expects a positive number of threads\n");
+      break;
     }
   }
 
@@ -85,7 +90,7 @@ int main(int argc, char **argv)
     }
     return 0;
   }
-  CausalizationStrategy cStrategy(mmo);
+  CausalizationStrategy cStrategy(mmo, jobs);
   cStrategy.Causalize();
   DEBUG('c', "Causalized Equations:\n");
   foreach_(const Equation &e, mmo.equations_ref().equations_ref())
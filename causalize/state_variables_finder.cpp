@@ -70,38 +70,39 @@ void StateVariablesFinder::findStateVariables()
 
 void StateVariablesFinder::operator()(Integer v) const { return; }
 void StateVariablesFinder::operator()(Boolean v) const { return; }
-void StateVariablesFinder::operator()(String v) const { return; }
-void StateVariablesFinder::operator()(Name v) const { return; }
+void StateVariablesFinder::operator()(const String &v) const { return; }
+void StateVariablesFinder::operator()(const AddAll &v) const { return; }
+void StateVariablesFinder::operator()(const Name &v) const { return; }
 void StateVariablesFinder::operator()(Real v) const { return; }
-void StateVariablesFinder::operator()(SubEnd v) const { return; }
-void StateVariablesFinder::operator()(SubAll v) const { return; }
-void StateVariablesFinder::operator()(BinOp v) const
+void StateVariablesFinder::operator()(const SubEnd &v) const { return; }
+void StateVariablesFinder::operator()(const SubAll &v) const { return; }
+void StateVariablesFinder::operator()(const BinOp &v) const
 {
   Expression l = v.left(), r = v.right();
   ApplyThis(l);
   ApplyThis(r);
 }
-void StateVariablesFinder::operator()(UnaryOp v) const
+void StateVariablesFinder::operator()(const UnaryOp &v) const
 {
   Expression e = v.exp();
   ApplyThis(e);
 }
-void StateVariablesFinder::operator()(IfExp v) const
+void StateVariablesFinder::operator()(const IfExp &v) const
 {
   Expression cond = v.cond(), then = v.then(), elseexp = v.elseexp();
   ApplyThis(cond);
   ApplyThis(then);
   ApplyThis(elseexp);
 }
-void StateVariablesFinder::operator()(Range v) const
+void StateVariablesFinder::operator()(const Range &v) const
 {
   Expression start = v.start(), end = v.end();
   ApplyThis(start);
   ApplyThis(end);
 }
-void StateVariablesFinder::operator()(Brace v) const { abort(); }
-void StateVariablesFinder::operator()(Bracket v) const { abort(); }
-void StateVariablesFinder::operator()(Call v) const
+void StateVariablesFinder::operator()(const Brace &v) const { abort(); }
+void StateVariablesFinder::operator()(const Bracket &v) const { abort(); }
+void StateVariablesFinder::operator()(const Call &v) const
 {
   if (v.name() == "der") {
     ERROR_UNLESS(v.args().size() == 1, "Call to der() with zero or more than one argument!");
@@ -121,14 +122,14 @@ void StateVariablesFinder::operator()(Call v) const
     foreach_(Expression e, v.args()) ApplyThis(e);
   }
 }
-void StateVariablesFinder::operator()(FunctionExp v) const { return; }
-void StateVariablesFinder::operator()(ForExp v) const { return; }
-void StateVariablesFinder::operator()(Named v) const { return; }
-void StateVariablesFinder::operator()(Output v) const
+void StateVariablesFinder::operator()(const FunctionExp &v) const { return; }
+void StateVariablesFinder::operator()(const ForExp &v) const { return; }
+void StateVariablesFinder::operator()(const Named &v) const { return; }
+void StateVariablesFinder::operator()(const Output &v) const
 {
   foreach_(OptExp oe, v.args())
   {
     if (oe) ApplyThis(oe.get());
   }
 }
-void StateVariablesFinder::operator()(Reference v) const { return; }
+void StateVariablesFinder::operator()(const Reference &v) const { return; }
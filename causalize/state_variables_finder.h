@@ -39,23 +39,24 @@ class StateVariablesFinder : public boost::static_visitor<void> {
   void findStateVariables();
   void operator()(Modelica::AST::Integer v) const;
   void operator()(Boolean v) const;
-  void operator()(String v) const;
-  void operator()(Name v) const;
+  void operator()(const String &v) const;
+  void operator()(const AddAll &v) const;
+  void operator()(const Name &v) const;
   void operator()(Real v) const;
-  void operator()(SubEnd v) const;
-  void operator()(SubAll v) const;
-  void operator()(BinOp) const;
-  void operator()(UnaryOp) const;
-  void operator()(Brace) const;
-  void operator()(Bracket) const;
-  void operator()(Call) const;
-  void operator()(FunctionExp) const;
-  void operator()(ForExp) const;
-  void operator()(IfExp) const;
-  void operator()(Named) const;
-  void operator()(Output) const;
-  void operator()(Reference) const;
-  void operator()(Range) const;
+  void operator()(const SubEnd &v) const;
+  void operator()(const SubAll &v) const;
+  void operator()(const BinOp &) const;
+  void operator()(const UnaryOp &) const;
+  void operator()(const Brace &) const;
+  void operator()(const Bracket &) const;
+  void operator()(const Call &) const;
+  void operator()(const FunctionExp &) const;
+  void operator()(const ForExp &) const;
+  void operator()(const IfExp &) const;
+  void operator()(const Named &) const;
+  void operator()(const Output &) const;
+  void operator()(const Reference &) const;
+  void operator()(const Range &) const;
 
   private:
   Modelica::MMO_Class &_c;
@@ -30,7 +30,9 @@
 #include <util/table.h>
 #include <util/type.h>
 #include <util/debug.h>
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 UnknownsCollector::UnknownsCollector(MMO_Class &c) : _c(c), _finder(c) {}
 
@@ -38,10 +40,14 @@ ExpList UnknownsCollector::collectUnknowns()
 {
   ExpList _unknowns;
   _finder.findStateVariables();
-  foreach_(VarSymbolTable::table_type::value_type val, _c.syms_ref())
+  // The symbol table is unordered, visit the variables by name so the
+  // unknowns (and hence the generated code) come out in a stable order.
+  std::vector<Name> names;
+  foreach_(VarSymbolTable::table_type::value_type val, _c.syms_ref()) names.push_back(val.first);
+  std::sort(names.begin(), names.end());
+  foreach_(Name name, names)
   {
-    VarInfo varInfo = val.second;
-    Name name = val.first;
+    VarInfo varInfo = *_c.syms_ref().lookup(name);
     if (!varInfo.builtin() && !isConstant(name, _c.syms_ref()) && !isDiscrete(name, _c.syms_ref()) && !isParameter(name, _c.syms_ref())) {
       Option<Type::Type> opt_type = _c.tyTable_ref()[varInfo.type()];
       ERROR_UNLESS((bool)opt_type, "No %s type found", varInfo.type().c_str());
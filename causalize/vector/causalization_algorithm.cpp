@@ -45,6 +45,7 @@ CausalizationStrategyVector::CausalizationStrategyVector(VectorCausalizationGrap
 {
   graph = g;
   step = 0;
+  fsolve = 1;
   VectorCausalizationGraph::vertex_iterator vi, vi_end;
   equationNumber = unknownNumber = 0;
   for (boost::tie(vi, vi_end) = vertices(graph); vi != vi_end; vi++) {
@@ -434,7 +435,7 @@ void CausalizationStrategyVector::SolveEquations()
     if (is<ForEq>(e)) {
       if (is<ForEq>(e)) {
         ForEq &feq = get<ForEq>(e);
-        VarSymbolTable syms = mmo.syms_ref();
+        VarSymbolTable &syms = mmo.syms_ref();
 
         int forIndex = cv.pairs.begin()->first;
         Expression varIndex = cv.pairs.begin()->second;
@@ -453,7 +454,7 @@ void CausalizationStrategyVector::SolveEquations()
         }
         std::stringstream s;
         s << mmo.name() << ".c";
-        all.push_back(EquationSolver::Solve(eq, cv.unknown(), syms, c_code, cl, s.str()));
+        all.push_back(EquationSolver::Solve(eq, cv.unknown(), syms, c_code, cl, s.str(), fsolve));
       } else {
         ERROR("Trying to solve an array variable with a non for equation");
       }
@@ -466,7 +467,7 @@ void CausalizationStrategyVector::SolveEquations()
       }
       std::stringstream s;
       s << mmo.name() << ".c";
-      all.push_back(EquationSolver::Solve(e, cv.unknown(), mmo.syms_ref(), c_code, cl, s.str()));
+      all.push_back(EquationSolver::Solve(e, cv.unknown(), mmo.syms_ref(), c_code, cl, s.str(), fsolve));
     }
   }
   mmo.equations_ref().equations_ref() = all;
@@ -37,6 +37,8 @@ class CausalizationStrategyVector {
   Option<std::pair<VectorEdge, IndexPairSet>> CanCausalizeUnknown(VectorUnknownVertex eq);
 
   int step;
+  /// @brief Number of the next non-linear solver function (fsolveN)
+  int fsolve;
   int equationNumber;
   int unknownNumber;
   Causalize::VectorCausalizationGraph graph;
@@ -31,14 +31,14 @@ using namespace Modelica::AST;
 
 namespace Causalize {
 ContainsVector::ContainsVector(Expression e, VectorVertexProperty v, const VarSymbolTable &s)
-    : exp(e), unk2find(v), syms(s), foreq(false), indexes(){};
+    : exp(e), unk2find(v), syms(&s), foreq(false), indexes(){};
 
 /**
  * Builds a ContainsVector class to find occurrences of the Expression 'e'
  * using the table of symbols 's' and index list 'indexes' in 'for-equations'.
  */
 ContainsVector::ContainsVector(VectorVertexProperty unk, VarSymbolTable &s, IndexList indexes)
-    : exp(unk.unknown()), unk2find(unk), syms(s), foreq(true), indexes(indexes)
+    : exp(unk.unknown()), unk2find(unk), syms(&s), foreq(true), indexes(indexes)
 {
   std::cout << "Looking for exp " << exp;
   ERROR_UNLESS(indexes.size() == 1, "For Loop with more than one index is not supported yet\n");
@@ -53,17 +53,17 @@ bool ContainsVector::operator()(Modelica::AST::Integer v) const { return exp ==
 
 bool ContainsVector::operator()(Boolean v) const { return exp == Expression(v); }
 
-bool ContainsVector::operator()(String v) const { return exp == Expression(v); }
+bool ContainsVector::operator()(const String &v) const { return exp == Expression(v); }
 
-bool ContainsVector::operator()(Name v) const { return exp == Expression(v); }
+bool ContainsVector::operator()(const Name &v) const { return exp == Expression(v); }
 
 bool ContainsVector::operator()(Real v) const { return exp == Expression(v); }
 
-bool ContainsVector::operator()(SubEnd v) const { return exp == Expression(v); }
+bool ContainsVector::operator()(const SubEnd &v) const { return exp == Expression(v); }
 
-bool ContainsVector::operator()(SubAll v) const { return exp == Expression(v); }
+bool ContainsVector::operator()(const SubAll &v) const { return exp == Expression(v); }
 
-bool ContainsVector::operator()(BinOp v) const
+bool ContainsVector::operator()(const BinOp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression l = v.left(), r = v.right();
@@ -72,14 +72,14 @@ bool ContainsVector::operator()(BinOp v) const
   return rr || rl;
 }
 
-bool ContainsVector::operator()(UnaryOp v) const
+bool ContainsVector::operator()(const UnaryOp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression e = v.exp();
   return ApplyThis(e);
 }
 
-bool ContainsVector::operator()(IfExp v) const
+bool ContainsVector::operator()(const IfExp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression cond = v.cond(), then = v.then(), elseexp = v.elseexp();
@@ -89,7 +89,7 @@ bool ContainsVector::operator()(IfExp v) const
   return rc || rt || re;
 }
 
-bool ContainsVector::operator()(Range v) const
+bool ContainsVector::operator()(const Range &v) const
 {
   if (exp == Expression(v)) return true;
   Expression start = v.start(), end = v.end();
@@ -98,19 +98,19 @@ bool ContainsVector::operator()(Range v) const
   return rs || re;
 }
 
-bool ContainsVector::operator()(Brace v) const
+bool ContainsVector::operator()(const Brace &v) const
 {
   if (exp == Expression(v)) return true;
   return false;
 }
 
-bool ContainsVector::operator()(Bracket v) const
+bool ContainsVector::operator()(const Bracket &v) const
 {
   if (exp == Expression(v)) return true;
   return false;
 }
 
-bool ContainsVector::operator()(Call call) const
+bool ContainsVector::operator()(const Call &call) const
 {
   if (is<Call>(exp)) {  // exp must be a derivative expression
     Call callExpr = get<Call>(exp);
@@ -136,32 +136,32 @@ bool ContainsVector::operator()(Call call) const
   return false;
 }
 
-bool ContainsVector::operator()(FunctionExp v) const
+bool ContainsVector::operator()(const FunctionExp &v) const
 {
   if (exp == Expression(v)) return true;
   return false;
 }
 
-bool ContainsVector::operator()(ForExp v) const
+bool ContainsVector::operator()(const ForExp &v) const
 {
   if (exp == Expression(v)) return true;
   return false;
 }
 
-bool ContainsVector::operator()(Named v) const
+bool ContainsVector::operator()(const Named &v) const
 {
   if (exp == Expression(v)) return true;
   return false;
 }
 
-bool ContainsVector::operator()(Output v) const
+bool ContainsVector::operator()(const Output &v) const
 {
   if (exp == Expression(v)) return true;
   foreach_(OptExp oe, v.args()) if (oe && ApplyThis(oe.get())) return true;
   return false;
 }
 
-bool ContainsVector::operator()(Reference ref) const
+bool ContainsVector::operator()(const Reference &ref) const
 {
   if (is<Reference>(exp)) {
     if (get<0>(ref.ref().front()) == get<0>(get<Reference>(exp).ref().front())) {  // The references are the same
@@ -35,23 +35,23 @@ class ContainsVector : public boost::static_visitor<bool> {
   ContainsVector(VectorVertexProperty, VarSymbolTable &, IndexList);
   bool operator()(Modelica::AST::Integer v) const;
   bool operator()(Boolean v) const;
-  bool operator()(String v) const;
-  bool operator()(Name v) const;
+  bool operator()(const String &v) const;
+  bool operator()(const Name &v) const;
   bool operator()(Real v) const;
-  bool operator()(SubEnd v) const;
-  bool operator()(SubAll v) const;
-  bool operator()(BinOp) const;
-  bool operator()(UnaryOp) const;
-  bool operator()(Brace) const;
-  bool operator()(Bracket) const;
-  bool operator()(Call) const;
-  bool operator()(FunctionExp) const;
-  bool operator()(ForExp) const;
-  bool operator()(IfExp) const;
-  bool operator()(Named) const;
-  bool operator()(Output) const;
-  bool operator()(Reference) const;
-  bool operator()(Range) const;
+  bool operator()(const SubEnd &v) const;
+  bool operator()(const SubAll &v) const;
+  bool operator()(const BinOp &) const;
+  bool operator()(const UnaryOp &) const;
+  bool operator()(const Brace &) const;
+  bool operator()(const Bracket &) const;
+  bool operator()(const Call &) const;
+  bool operator()(const FunctionExp &) const;
+  bool operator()(const ForExp &) const;
+  bool operator()(const IfExp &) const;
+  bool operator()(const Named &) const;
+  bool operator()(const Output &) const;
+  bool operator()(const Reference &) const;
+  bool operator()(const Range &) const;
   IndexPairSet getOccurrenceIndexes() { return labels; }
   //    void setForIndex(Expression a, Expression b, Name v);
   private:
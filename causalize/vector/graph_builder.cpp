@@ -72,7 +72,7 @@ VectorCausalizationGraph ReducedGraphBuilder::makeGraph()
   {
     static int index = 0;
     const VarSymbolTable &syms = mmo_class.syms_ref();
-    VarInfo varInfo = syms[var].get();
+    const VarInfo &varInfo = *syms.lookup(var);
     if (!isConstant(var, syms) && !isBuiltIn(var, syms) && !isDiscrete(var, syms) && !isParameter(var, syms)) {
       VectorVertexProperty vp;
       vp.type = U;
@@ -103,7 +103,7 @@ VectorCausalizationGraph ReducedGraphBuilder::makeGraph()
     foreach_(VectorUnknownVertex un, unknownDescriptorList)
     {
       Expression unknown = graph[un].unknown();
-      VarSymbolTable syms = mmo_class.syms_ref();
+      const VarSymbolTable &syms = mmo_class.syms_ref();
       Equation e = graph[eq].equation;
       if (is<Equality>(e)) {
         Causalize::ContainsVector occurrs(unknown, graph[un], syms);
@@ -135,7 +135,7 @@ VectorCausalizationGraph ReducedGraphBuilder::makeGraph()
         Range range = get<Range>(exp);
         ERROR_UNLESS(!range.step(), "Range with step not supported");
 
-        VarSymbolTable syms_for = mmo_class.syms_ref();
+        VarSymbolTable syms_for(&mmo_class.syms_ref());
         syms_for.insert(i.name(), VarInfo(TypePrefixes(0), "Integer"));
         Causalize::ContainsVector occurrs_for(graph[un], syms_for, ind);
 
@@ -22,11 +22,42 @@
 #include <boost/variant/get.hpp>
 #include <iostream>
 #include <util/debug.h>
+#include <util/thread_pool.h>
 
 using namespace std;
 using namespace Modelica;
 
-ClassFinder::ClassFinder() {}
+ClassFinder::ClassFinder() : _hits(0), _misses(0) {}
+
+int ClassFinder::cacheHits() const { return _hits; }
+
+int ClassFinder::cacheMisses() const { return _misses; }
+
+void ClassFinder::adopt(ClassFinder &other) { _owned.splice(_owned.end(), other._owned); }
+
+MMO_Class &ClassFinder::own(const MMO_Class &c)
+{
+  _owned.push_back(c);
+  return _owned.back();
+}
+
+Name ClassFinder::scopeName(const MMO_Class *c) const
+{
+  if (!c) return Name();
+  Name qualified = c->name();
+  for (const MMO_Class *f = c->father(); f; f = f->father()) qualified = f->name() + "." + qualified;
+  // The root, or a class its father stores under its name
+  bool stored = !c->father();
+  if (!stored) {
+    const Type::Type *t = c->father()->tyTable().lookup(c->name());
+    stored = t && is<Type::Class>(*t) && boost::get<Type::Class>(*t).clase() == c;
+  }
+  if (!stored) {
+    boost::unordered_map<Name, MMO_Class *>::const_iterator it = _expanded.find(qualified);
+    stored = it != _expanded.end() && it->second == c;
+  }
+  return stored ? qualified : Name();
+}
 
 void ClassFinder::expand(MMO_Class &up, MMO_Class &down)
 {
@@ -100,28 +131,22 @@ void ClassFinder::ExpandAll(MMO_Class &up)
 
       } else {
         std::cerr << "Error expandiendo. " << e.name() << " no es del tipo Class" << std::endl;
-        exit(-1);
+        fatalExit(-1);
       }
     } else {
       std::cerr << "Error expandiendo. Clase no encontrada: " << e.name() << std::endl;
-      exit(-1);
+      fatalExit(-1);
     }
   }
 }
 
-#define newMMO(NEW, OLD)              \
-  MMO_Class *(NEW) = new MMO_Class(); \
-  *(NEW) = (OLD);
-
 Option<typeContexTuple> ClassFinder::findTypeByName(MMO_Class &c, Name n)
 {
   Option<Type::Type> t = c.tyTable_ref()[n];
-  newMMO(contex, c) if (t) { return typeContexTuple(t.get(), *contex); }
-  else if (c.father())
-  {
-    MMO_Class cc = *c.father();
-    return findTypeByName(cc, n);
-  }
+  if (t) {
+    return typeContexTuple(t.get(), own(c));
+  } else if (c.father())
+    return findTypeByName(*c.father(), n);
   return Option<typeContexTuple>();
 }
 
@@ -134,7 +159,7 @@ OptTypeDefinition ClassFinder::getFinalClass(MMO_Class &c, Type::Type t)
       typeDefinition td = op.get();
       Type::Type t_final = get<1>(td);
       if (is<Type::Class>(t_final) && df.modification()) {
-        newMMO(d, *(boost::get<Type::Class>(t_final).clase()));
+        MMO_Class *d = &own(*(boost::get<Type::Class>(t_final).clase()));
         ExpandAll(*d);
         applyClassModification(c, *d, df.modification().get());
         t_final = Type::Class(d->name(), d);
@@ -146,8 +171,19 @@ OptTypeDefinition ClassFinder::getFinalClass(MMO_Class &c, Type::Type t)
     } else
       return OptTypeDefinition();
   } else if (is<Type::Class>(t)) {
-    newMMO(d, *(boost::get<Type::Class>(t).clase()));
-    ExpandAll(*d);
+    const MMO_Class *clase = boost::get<Type::Class>(t).clase();
+    Name key = scopeName(clase);
+    boost::unordered_map<Name, MMO_Class *>::const_iterator it = _expanded.find(key);
+    MMO_Class *d;
+    if (!key.empty() && it != _expanded.end()) {
+      _hits++;
+      d = it->second;
+    } else {
+      _misses++;
+      d = &own(*clase);
+      ExpandAll(*d);
+      if (!key.empty()) _expanded[key] = d;
+    }
     Type::Class t_final = Type::Class(d->name(), d);
     return OptTypeDefinition(typeDefinition(TypePrefixes(), t_final, ExpList()));
   }
@@ -155,16 +191,36 @@ OptTypeDefinition ClassFinder::getFinalClass(MMO_Class &c, Type::Type t)
 }
 
 // Tipo simple: A
-OptTypeDefinition ClassFinder::resolveDependencies(MMO_Class &c, Name n)
+OptTypeDefinition ClassFinder::resolveDependencies(MMO_Class &c, Name n) { return resolveDependencies(c, Name(), n); }
+
+// scope: scopeName of c, empty if c may have been modified
+OptTypeDefinition ClassFinder::resolveDependencies(MMO_Class &c, const Name &scope, Name n)
 {
-  Option<typeContexTuple> op = findTypeByName(c, n);
-  if (op) {
-    MMO_Class &contex = get<1>(op.get());
-    ExpandAll(contex);
-    Type::Type t = get<0>(op.get());
-    return getFinalClass(contex, t);
-  } else
-    return OptTypeDefinition();
+  // A name not declared in c is resolved in its father, which is a class of a type table
+  if (scope.empty() && c.father() && !c.tyTable_ref().lookup(n))
+    return resolveDependencies(*c.father(), scopeName(c.father()), n);
+  if (!scope.empty()) {
+    boost::unordered_map<std::pair<Name, Name>, OptTypeDefinition>::const_iterator it = _resolved.find(std::make_pair(scope, n));
+    if (it != _resolved.end()) {
+      _hits++;
+      return it->second;
+    }
+    _misses++;
+  }
+  OptTypeDefinition res;
+  MMO_Class *k = &c;
+  const Type::Type *t = NULL;
+  while (k && !(t = k->tyTable_ref().lookup(n))) k = k->father();
+  if (t) {
+    if (is<Type::TypeDef>(*t)) {  // Only type definitions are resolved in the scope they are found in
+      MMO_Class &contex = own(*k);
+      ExpandAll(contex);
+      res = getFinalClass(contex, *t);
+    } else
+      res = getFinalClass(*k, *t);
+  }
+  if (!scope.empty()) _resolved[std::make_pair(scope, n)] = res;
+  return res;
 }
 
 // Tipo entrada: Tipos compuestos A.B.C.D.E
@@ -174,16 +230,18 @@ OptTypeDefinition ClassFinder::resolveType(MMO_Class &c, Name t)
   boost::split(ts, t, boost::is_any_of("."));
   int i = 1, size = ts.size();
   ExpList index;
-  MMO_Class contex = c;
+  // Resolution only reads the scopes, so they are walked without copying them
+  MMO_Class *contex = &c;
+  Name scope;
   TypePrefixes tpre;
   Type::Type t_final;
   foreach_(Name name, ts)
   {
-    if (i == 1 && contex.name() == name) {
+    if (i == 1 && contex->name() == name) {
       i++;
       continue;
     }
-    OptTypeDefinition otd = resolveDependencies(contex, name);
+    OptTypeDefinition otd = resolveDependencies(*contex, scope, name);
     if (otd) {
       typeDefinition td = otd.get();
       t_final = get<1>(td);
@@ -191,17 +249,18 @@ OptTypeDefinition ClassFinder::resolveType(MMO_Class &c, Name t)
       tpre = get<0>(td);
       if (!is<Type::Class>(t_final) && i != size && size > 1) {
         std::cerr << "Error: " << t_final << " no es de tipo clase " << std::endl;
-        exit(-1);
+        fatalExit(-1);
         return OptTypeDefinition();
       } else if (is<Type::Class>(t_final)) {
         Type::Class tc = boost::get<Type::Class>(t_final);
-        contex = *tc.clase();
+        contex = tc.clase();
+        scope = scopeName(tc.clase());
       }
       i++;
     } else {
       std::cerr << "Error buscando el tipo " << name << " en " << t << std::endl;
       c.tyTable_ref().dump();
-      exit(-1);
+      fatalExit(-1);
       return OptTypeDefinition();
     }
   }
@@ -295,7 +354,7 @@ void ClassFinder::applyArgument(MMO_Class &contex, MMO_Class &target, Argument m
       target.syms_ref().insert(mod.name(), v);
     } else {
       std::cout << "Error no encuentro variable: " << mod.name() << " en clase " << target.name() << std::endl;
-      exit(-1);
+      fatalExit(-1);
     }
     return;
   } else if (is<ElRepl>(m)) {
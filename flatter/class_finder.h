@@ -22,6 +22,8 @@
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/unordered_map.hpp>
+#include <list>
 #include <ast/class.h>
 #include <mmo/mmo_class.h>
 #include <ast/equation.h>
@@ -52,7 +54,37 @@ struct ClassFinder {
   void applyArgument(MMO_Class &, MMO_Class &, Argument);
   void applyClassModification(MMO_Class &, MMO_Class &, ClassModification);
 
+  /// @brief Resolutions answered from the cache
+  int cacheHits() const;
+  /// @brief Resolutions that had to walk the scopes
+  int cacheMisses() const;
+
+  /// @brief Takes over the classes other made. The types it resolved point
+  /// to them, and stay valid for as long as this ClassFinder.
+  void adopt(ClassFinder &other);
+
   private:
+  // The classes made here are pointed to by the types handed out
+  ClassFinder(const ClassFinder &);
+  ClassFinder &operator=(const ClassFinder &);
+
+  OptTypeDefinition resolveDependencies(MMO_Class &c, const Name &scope, Name n);
+  /// @brief Qualified name of c if it is a class of a type table, or the
+  /// expanded copy kept for one. Empty for any other class, such as a
+  /// modified copy, which must not be looked up in the caches.
+  Name scopeName(const MMO_Class *c) const;
+  /// @brief A copy of c that lives as long as this ClassFinder
+  MMO_Class &own(const MMO_Class &c);
+
+  /// Only classes of a type table are used as scopes. Those are never
+  /// modified once stored: modifications and expansions always act on copies,
+  /// so a (scope, name) entry stays valid for the whole flattening.
+  boost::unordered_map<std::pair<Name, Name>, OptTypeDefinition> _resolved;
+  /// Expanded copy of each class of a type table, by scopeName
+  boost::unordered_map<Name, MMO_Class *> _expanded;
+  /// Every class made here. Nodes never move, so pointers to them stay valid.
+  std::list<MMO_Class> _owned;
+  int _hits, _misses;
 };
 
 #endif
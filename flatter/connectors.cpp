@@ -12,8 +12,12 @@
     along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <chrono>
+#include <cmath>
+#include <unistd.h>
 
 #include <flatter/connectors.h>
 
@@ -28,7 +32,7 @@ using namespace Modelica::AST;
 #define PrintOpt(N) (N ? N.get() : "{}")
 
 Connectors::Connectors(MMO_Class &c) 
- : mmoclass_(c), eCount2_(0){
+ : mmoclass_(c), eCount2_(0), graphTime_(0), componentsTime_(0), codeTime_(0){
   SBGraph g;
   G = g;
 }
@@ -39,6 +43,16 @@ member_imp(Connectors, int, eCount2);
 member_imp(Connectors, MMO_Class, mmoclass);
 member_imp(Connectors, VertexNameTable, vnmtable);
 member_imp(Connectors, NameVertexTable, nmvtable);
+member_imp(Connectors, vector<Name>, forIndexes);
+member_imp(Connectors, double, graphTime);
+member_imp(Connectors, double, componentsTime);
+member_imp(Connectors, double, codeTime);
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start){
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
 
 /*|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||*/
 /*-----------------------------------------------------------------------------------------------*/
@@ -76,12 +90,12 @@ void Connectors::debug(std::string filename){
 /*-----------------------------------------------------------------------------------------------*/
 /*|||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||*/
 
-void Connectors::solve(){
+void Connectors::solve(int jobs){
   int maxdim = 1;
   foreach_(Name n, mmoclass_.variables()){
-    Option<VarInfo> ovi = mmoclass_.getVar(n);
+    const VarInfo *ovi = mmoclass_.lookupVar(n);
     if(ovi){
-      VarInfo vi = *ovi;
+      const VarInfo &vi = *ovi;
       Option<ExpList> oinds = vi.indices();
       if(oinds){
         ExpList inds = *oinds;
@@ -95,35 +109,45 @@ void Connectors::solve(){
   set_vCount(aux);
   set_eCount1(aux);
 
-  createGraph(mmoclass_.equations_ref().equations_ref());
+  Clock::time_point start = Clock::now();
+  createGraph(mmoclass_.equations_ref().equations_ref(), mmoclass_.syms_ref());
+  set_graphTime(secondsSince(start));
 
   debug("prueba.dot");
 
+  start = Clock::now();
   PWLMap res = connectedComponents(G);
+  set_componentsTime(secondsSince(start));
   cout << "\n" << res << "\n";
+
+  start = Clock::now();
   generateCode(res);
+  set_codeTime(secondsSince(start));
 
-  foreach_(Name nm, mmoclass_.variables()){
-    Option<VarInfo> ovi = mmoclass_.getVar(nm);
+  // rmVar edits the list, walk a snapshot of it
+  vector<Name> vars = mmoclass_.variables();
+  foreach_(Name nm, vars){
+    const VarInfo *ovi = mmoclass_.lookupVar(nm);
     if(ovi){
-      VarInfo vi = *ovi;
-      Name ty = vi.type();
+      Name ty = ovi->type();
       if(ty != "Real" && ty != "Integer")
         mmoclass_.rmVar(nm);
     }
   }
 
-  cout << mmoclass_ << "\n";
+  cout.flush();
+  if(!writeClass(STDOUT_FILENO, mmoclass_, jobs))
+    ERROR("Can't write the flat class");
 }
 
-void Connectors::createGraph(EquationList &eqs){
+void Connectors::createGraph(EquationList &eqs, const VarSymbolTable &syms){
   foreach_(Equation &eq, eqs){
     if(is<Connect>(eq))
-      connect(get<Connect>(eq));
+      connect(get<Connect>(eq), syms);
 
     else if(is<ForEq>(eq)){
-      vector<Name> auxvars;
-      vector<Name>::iterator itvars = auxvars.begin();
+      // The for indexes are only visible inside the loop
+      VarSymbolTable scope(&syms);
       ForEq feq = boost::get<ForEq>(eq);
       foreach_(Index ind, feq.range().indexes()){
         Name n = ind.name();
@@ -137,25 +161,22 @@ void Connectors::createGraph(EquationList &eqs){
           Option<Modification> mod(aux4);
           ExpOptList aux5;
           VarInfo vi(tp, n, aux1, mod, aux5, false);
-          mmoclass_.addVar(n, vi);
-          itvars = auxvars.insert(itvars, n);
-          ++itvars;
+          scope.insert(n, vi);
         }
         else 
           cerr << "Should be defined\n";
       }
 
       EquationList el = feq.elements();
-      createGraph(el);
-
-      foreach_(Name auxnm, auxvars){
-        mmoclass_.rmVar(auxnm);
-      }
+      foreach_(Index ind, feq.range().indexes())
+        forIndexes_.push_back(ind.name());
+      createGraph(el, scope);
+      forIndexes_.resize(forIndexes_.size() - feq.range().indexes().size());
     }
   }
 }
 
-void Connectors::connect(Connect co){
+void Connectors::connect(Connect co, const VarSymbolTable &syms){
   Expression eleft = co.left(), eright = co.right();
   
   Pair<Name, ExpOptList> left = separate(eleft);
@@ -164,141 +185,32 @@ void Connectors::connect(Connect co){
   Name v1 = get<0>(left);
   Name v2 = get<0>(right);
 
-  OrdCT<Interval> miv1 = createVertex(v1).inters_();
-  OrdCT<Interval>::iterator itmiv1 = miv1.begin(); 
-  OrdCT<Interval> miv2 = createVertex(v2).inters_();
-  OrdCT<Interval>::iterator itmiv2 = miv2.begin();
-
-  ExpOptList range1 = get<1>(left);
-  ExpOptList range2 = get<1>(right);
-
-  if(checkRanges(range1, range2)){
-    OrdCT<Interval> mi11;
-    OrdCT<Interval>::iterator itmi11 = mi11.begin();
-    int dim = 0;
-    const VarSymbolTable aux = mmoclass_.syms();
-    EvalExpFlatter evexp(aux);
-    if(range1){
-      foreach_(Expression e1, range1.get()){
-        if(is<SubAll>(e1)){
-          Option<VarInfo> ovi = mmoclass_.getVar(v1);
-          if(ovi){
-            VarInfo vi = *ovi;
-            ExpOptList oinds = vi.indices();
-            if(oinds){
-              ExpList inds = *oinds;
-              ExpList::iterator itinds = inds.begin();
-
-              for(int i = 0; i < dim; ++i)
-                ++itinds;
-
-              e1 = *itinds;
-            }
-          }
-        }
-
-        Interval ll = Apply(evexp, e1);
-        NI1 auxlo = (*itmiv1).lo_() - 1;
-        Interval l(auxlo + ll.lo_(), ll.step_(), auxlo + ll.hi_());
-        ++itmiv1;
-      
-        if(!l.empty_()){
-          itmi11 = mi11.insert(itmi11, l);
-          ++itmi11;
-          ++dim;
-        }
+  vector<SubscriptWalk> walk1, walk2;
+  MultiInterval mi1 = connectRange(v1, get<1>(left), syms, walk1);
+  MultiInterval mi2 = connectRange(v2, get<1>(right), syms, walk2);
 
-        else{
-          OrdCT<Interval> aux;
-          mi11 = aux;
-          break;
-        }
-      }
-    }
+  checkRanges(walk1, walk2);
 
-    else{
-      itmi11 = mi11.begin();
-      foreach_(Interval i1, miv1){
-        NI1 auxlo = i1.lo_();
-        Interval l(auxlo, 1, auxlo);
-        itmi11 = mi11.insert(itmi11, l);
-        ++itmi11;
-      }
-    }
-
-    MultiInterval mi1(mi11);
-
-    OrdCT<Interval> mi22;
-    OrdCT<Interval>::iterator itmi22 = mi22.begin();
-    dim = 0;
-    if(range2){
-      foreach_(Expression e2, range2.get()){
-        if(is<SubAll>(e2)){
-          Option<VarInfo> ovi = mmoclass_.getVar(v2);
-          if(ovi){
-            VarInfo vi = *ovi;
-            ExpOptList oinds = vi.indices();
-            if(oinds){
-              ExpList inds = *oinds;
-              ExpList::iterator itinds = inds.begin();
-
-              for(int i = 0; i < dim; ++i)
-                ++itinds;
-
-              e2 = *itinds;
-            }
-          }
-        }
-
-        Interval rr = Apply(evexp, e2);
-        NI1 auxlo = (*itmiv2).lo_() - 1;
-        Interval r(auxlo + rr.lo_(), rr.step_(), auxlo + rr.hi_());
-        ++itmiv2;
-
-        if(!r.empty_()){
-          itmi22 = mi22.insert(itmi22, r);
-          ++itmi22;
-          ++dim;
-        }
-
-        else{
-          OrdCT<Interval> aux;
-          mi22 = aux;
-          break;
-        }
-      }
-    }
+  VertexIt vi, vi_end;
+  boost::tie(vi, vi_end) = boost::vertices(G);
+  SetVertexDesc d1 = *vi, d2 = *vi;
+  bool found1 = false, found2 = false;
 
-    else{
-      itmi22 = mi22.begin();
-      foreach_(Interval i2, miv2){
-        NI1 auxlo = i2.lo_();
-        Interval r(auxlo, 1, auxlo);
-        itmi22 = mi22.insert(itmi22, r);
-        ++itmi22;
-      }
+  for(; vi != vi_end; ++vi){
+    Name aux = G[*vi].name;
+    if(aux == v1){
+      d1 = *vi;
+      found1 = true;
     }
 
-    MultiInterval mi2(mi22);
-
-    VertexIt vi1, vi2, vi_end1, vi_end2;
-    boost::tie(vi1, vi_end1) = boost::vertices(G);
-    SetVertexDesc d1 = *vi1, d2 = *vi2;
-
-    for(; vi1 != vi_end1; ++vi1){
-      boost::tie(vi2, vi_end2) = boost::vertices(G);
-      Name aux1 = G[*vi1].name;
-
-      for(; vi2 != vi_end2; ++vi2){
-        Name aux2 = G[*vi2].name;
-        if(aux1 == v1 && aux2 == v2){
-          d1 = *vi1;
-          d2 = *vi2;
-          updateGraph(d1, d2, mi1, mi2);
-        }
-      }
+    if(aux == v2){
+      d2 = *vi;
+      found2 = true;
     }
   }
+
+  if(found1 && found2)
+    updateGraph(d1, d2, mi1, mi2);
 }
 
 // Get expression and range
@@ -343,9 +255,9 @@ MultiInterval Connectors::createVertex(Name n){
   }
   
   if(!exists){
-    Option<VarInfo> ovi = mmoclass_.getVar(n);
+    const VarInfo *ovi = mmoclass_.lookupVar(n);
     if(ovi){
-      VarInfo vi = *ovi;
+      const VarInfo &vi = *ovi;
       ExpOptList oinds = vi.indices();
       // Multi dimensional variable
       if(oinds){
@@ -358,8 +270,7 @@ MultiInterval Connectors::createVertex(Name n){
         vector<NI1> newvc;
         vector<NI1>::iterator itnew = newvc.begin();
    
-        const VarSymbolTable auxt = mmoclass_.syms();
-        EvalExpression evexp(auxt);
+        EvalExpression evexp(mmoclass_.syms_ref());
   
         foreach_(Expression e, inds){
           if(is<SubAll>(e) || is<Range>(e))
@@ -438,55 +349,136 @@ MultiInterval Connectors::createVertex(Name n){
   return mires;
 }
 
-// Check if only one variable is used at each subscript
-bool Connectors::checkRanges(ExpOptList range1, ExpOptList range2){
-  std::vector<Name> vars = mmoclass_.variables();
+// Values of an affine subscript e, that uses at most one of the for indexes
+static Interval affineRange(Expression e, const vector<Name> &indexes, const VarSymbolTable &syms, SubscriptWalk &w){
+  foreach_(Name k, indexes){
+    ContainsExpression co(NameToRef(k));
+    if(Apply(co, e)){
+      if(w.index && *w.index != k)
+        ERROR("Only one for index permitted at connect subscript");
+      w.index = k;
+    }
+  }
 
-  if(range1 && range2){
-    ExpList r1 = range1.get();
-    ExpList r2 = range2.get();
- 
-    if(r1.size() == 0 || r2.size() == 0)
-      return true;
+  if(!w.index){
+    EvalExpression evexp(syms);
+    NI1 c = Apply(evexp, e);
+    return Interval(c, 1, c);
+  }
+
+  // Sampling three points is enough to get gain and offset, and to reject
+  // subscripts like i * i
+  Name k = *w.index;
+  EvalExpression f0(syms, k, 0), f1(syms, k, 1), f2(syms, k, 2);
+  Real off = Apply(f0, e);
+  Real gain = Apply(f1, e) - off;
+  if(Apply(f2, e) != 2 * gain + off || gain != floor(gain) || off != floor(off))
+    ERROR("Connect subscript is not affine in %s", k.c_str());
+
+  if(gain == 0){
+    w.index = Option<Name>();
+    return Interval(off, 1, off);
+  }
 
-    else if(r1.size() != r2.size()){
-      cerr << "Unmatched dimensions in equation connect" << endl;
-      return false;
+  EvalExpFlatter evexp(syms);
+  Expression ek = NameToRef(k);
+  Interval ks = Apply(evexp, ek);
+  NI1 first = gain * ks.lo_() + off, last = gain * ks.hi_() + off;
+  if(gain > 0)
+    return Interval(first, gain * ks.step_(), last);
+
+  // Walked backwards: the other side must do the same, so that the two
+  // ascending intervals still pair the same values of k
+  w.reversed = true;
+  return Interval(last, -gain * ks.step_(), first);
+}
+
+// Elements of the vertex of n reached by the subscripts in range
+MultiInterval Connectors::connectRange(Name n, ExpOptList range, const VarSymbolTable &syms, vector<SubscriptWalk> &walks){
+  MultiInterval vertex = createVertex(n);
+  OrdCT<Interval> miv = vertex.inters_();
+
+  // Whole variable
+  if(!range){
+    foreach_(Interval i, miv){
+      SubscriptWalk w;
+      w.slice = i.size() > 1;
+      walks.push_back(w);
     }
 
-    else{
-      ExpList::iterator it1 = r1.begin(), it2 = r2.begin();
+    return vertex;
+  }
 
-      while(it1 != r1.end()){
-        foreach_(Name n1, vars){
-          Expression e1(n1);
-          ContainsExpression co1(e1);
- 
-          bool cn11 = Apply(co1, *it1);
-          bool cn21 = Apply(co1, *it2);
+  ExpList inds;
+  const VarInfo *ovi = mmoclass_.lookupVar(n);
+  if(ovi && ovi->indices())
+    inds = *ovi->indices();
+  if(range->size() != miv.size() || inds.size() != miv.size())
+    ERROR("Unmatched dimensions in connect of %s", n.c_str());
+
+  EvalExpFlatter evexp(syms);
+  OrdCT<Interval> mi;
+  OrdCT<Interval>::iterator itmiv = miv.begin();
+  ExpList::iterator itinds = inds.begin();
+  foreach_(Expression e, range.get()){
+    SubscriptWalk w;
+    Interval values;
+    if(is<SubAll>(e)){
+      w.slice = true;
+      Expression all = Range(1, *itinds);
+      values = Apply(evexp, all);
+    }
 
-          // This loop checks that there is only one variable at each subscript
-          foreach_(Name n2, vars){
-            Expression e2(n2);
-            ContainsExpression co2(e2);
+    else if(is<Range>(e)){
+      w.slice = true;
+      values = Apply(evexp, e);
+    }
 
-            bool cn12 = Apply(co2, *it1);
-            bool cn22 = Apply(co2, *it2);
+    else
+      values = affineRange(e, forIndexes_, syms, w);
 
-            if(((cn11 && cn12) || (cn21 && cn22)) && (n1 != n2)){
-              cerr << "Only one variable permitted at subscript";
-              return false;
-            }
-          }
-        }
+    NI1 auxlo = (*itmiv).lo_() - 1;
+    Interval l(auxlo + values.lo_(), values.step_(), auxlo + values.hi_());
+    if(l.empty_())
+      return MultiInterval();
 
-        ++it1;
-        ++it2;
-      }
-    }
+    mi.insert(mi.end(), l);
+    walks.push_back(w);
+    ++itmiv;
+    ++itinds;
   }
 
-  return true;
+  return MultiInterval(mi);
+}
+
+// Check that both sides walk their dimensions in lockstep, the only pairing
+// the linear maps of an edge can express
+// Connects that can't be mapped onto one edge per index are errors, never
+// dropped
+void Connectors::checkRanges(const vector<SubscriptWalk> &walk1, const vector<SubscriptWalk> &walk2){
+  if(walk1.size() != walk2.size())
+    ERROR("Unmatched dimensions in equation connect");
+
+  for(unsigned int d = 0; d < walk1.size(); ++d){
+    const SubscriptWalk &w1 = walk1[d], &w2 = walk2[d];
+    if((w1.index && w2.slice) || (w1.slice && w2.index))
+      ERROR("A for index and a slice can not be paired in connect");
+
+    if(w1.index && w2.index && w1.reversed != w2.reversed)
+      ERROR("Connect subscripts walk %s in opposite directions", w1.index->c_str());
+
+    // An index must sit at the same dimension wherever it is used
+    for(unsigned int o = 0; o < walk1.size(); ++o){
+      if(w1.index && walk2[o].index && *w1.index == *walk2[o].index && o != d)
+        ERROR("Connect subscripts permute for index %s", w1.index->c_str());
+
+      if(o != d && w1.index && walk1[o].index && *w1.index == *walk1[o].index)
+        ERROR("For index %s used at several subscripts of a connect", w1.index->c_str());
+
+      if(o != d && w2.index && walk2[o].index && *w2.index == *walk2[o].index)
+        ERROR("For index %s used at several subscripts of a connect", w2.index->c_str());
+    }
+  }
 }
 
 Option<SetEdgeDesc> Connectors::existsEdge(SetVertexDesc d1, SetVertexDesc d2){
@@ -580,11 +572,8 @@ void Connectors::updateGraph(SetVertexDesc d1, SetVertexDesc d2,
         ++itec;
       }
  
-      else{ 
-        cerr << "Incompatible connect\n"; 
-        newec = eCount1_;
-        break;
-      }
+      else
+        ERROR("Incompatible connect of %s and %s", G[d1].name.c_str(), G[d2].name.c_str());
 
       ++itints1;
       ++itints2;
@@ -642,16 +631,103 @@ void Connectors::updateGraph(SetVertexDesc d1, SetVertexDesc d2,
   }
 
   else
-    cerr << "Incompatible connect\n";
+    ERROR("Incompatible connect of %s and %s", G[d1].name.c_str(), G[d2].name.c_str());
 }
 
-void Connectors::generateCode(PWLMap pw){
-  EquationList res;
-  EquationList::iterator itres = res.begin();
+// Preimage under pw of each atom in atoms, in one pass over the pieces of pw.
+// The atoms are indexed by their first interval, so each piece only tests
+// the atoms its image can reach. Each preimage is assembled in the same order
+// PWLMap::preImage uses.
+vector<Set> Connectors::preImages(PWLMap pw, vector<AtomSet> &atoms){
+  vector<Set> res(atoms.size());
+
+  // Atoms sorted by the lower end of their first interval, and the highest
+  // upper end among the atoms up to each position
+  vector<unsigned int> order(atoms.size());
+  vector<NI1> los(atoms.size()), maxhis(atoms.size());
+  vector<Interval> firsts;
+  firsts.reserve(atoms.size());
+  bool indexed = true;
+  for(unsigned int j = 0; j < atoms.size(); ++j){
+    OrdCT<Interval> ints = atoms[j].aset_().inters_();
+    indexed = indexed && !ints.empty();
+    firsts.push_back(ints.empty() ? Interval() : ints.front());
+    order[j] = j;
+  }
+  sort(order.begin(), order.end(), [&firsts](unsigned int j1, unsigned int j2){
+    return firsts[j1].lo_() < firsts[j2].lo_();
+  });
+  for(unsigned int q = 0; q < order.size(); ++q){
+    los[q] = firsts[order[q]].lo_();
+    maxhis[q] = q == 0 ? firsts[order[q]].hi_() : max(maxhis[q - 1], firsts[order[q]].hi_());
+  }
+
+  vector<Set> partial(atoms.size());
+  vector<unsigned int> touched, candidates;
+
+  OrdCT<Set> dom = pw.dom_();
+  OrdCT<LMap> lm = pw.lmap_();
+  OrdCT<LMap>::iterator itlm = lm.begin();
+  foreach_(Set ss, dom){
+    foreach_(AtomSet as1, ss.asets_()){
+      PWAtomLMap auxMap(as1, *itlm);
+      AtomSet im = auxMap.image(as1);
+
+      candidates.clear();
+      OrdCT<Interval> imints = im.aset_().inters_();
+      if(indexed && !imints.empty()){
+        Interval first = imints.front();
+        unsigned int q = upper_bound(los.begin(), los.end(), first.hi_()) - los.begin();
+        for(; q > 0 && maxhis[q - 1] >= first.lo_(); --q)
+          candidates.push_back(order[q - 1]);
+      }
+
+      else
+        for(unsigned int j = 0; j < atoms.size(); ++j)
+          candidates.push_back(j);
 
+      foreach_(unsigned int j, candidates){
+        if(im.cap(atoms[j]).empty())
+          continue;
+
+        if(partial[j].empty())
+          touched.push_back(j);
+        AtomSet aux = auxMap.preImage(atoms[j]);
+        partial[j].addAtomSet(aux);
+      }
+    }
+
+    foreach_(unsigned int j, touched){
+      if(!partial[j].empty())
+        res[j] = res[j].cup(partial[j]);
+      partial[j] = Set();
+    }
+    touched.clear();
+
+    ++itlm;
+  }
+
+  return res;
+}
+
+void Connectors::generateCode(PWLMap pw){
   Set vcdom = pw.wholeDom();
   Set vcim = pw.image(vcdom);
 
+  vector<AtomSet> atoms;
+  foreach_(AtomSet as, vcim.asets_())
+    atoms.push_back(as);
+  vector<Set> preims = preImages(pw, atoms);
+
+  // At least a flow equation per connection set
+  EquationList res;
+  res.reserve(2 * atoms.size());
+
+  // Variables of equality in the ForEq
+  Pair<vector<Name>, vector<Name>> p = separateVars();
+  const vector<Name> &effvars = get<0>(p);
+  const vector<Name> &flowvars = get<1>(p);
+
   ExpList nms;
   ExpList::iterator itnms = nms.begin();
   int ascii = 0;
@@ -663,15 +739,13 @@ void Connectors::generateCode(PWLMap pw){
     ++ascii;
   }
 
-  foreach_(AtomSet as, vcim.asets_()){
+  for(unsigned int k = 0; k < atoms.size(); ++k){
+    AtomSet &as = atoms[k];
     Set auxs;
     auxs.addAtomSet(as);
-    Set vcdomi = pw.preImage(auxs);
+    Set &vcdomi = preims[k];
     Set vcdomiaux = vcdomi.diff(auxs);
 
-    // Variables of equality in the ForEq
-    Pair<vector<Name>, vector<Name>> p = separateVars();
-
     foreach_(AtomSet auxi, vcdomiaux.asets_()){
       MultiInterval mi = auxi.aset_();
 
@@ -679,9 +753,14 @@ void Connectors::generateCode(PWLMap pw){
       IndexList::iterator itran1 = ran1.begin(); 
       OrdCT<NI1> off1 = getOff(mi);
       MultiInterval mirange1 = applyOff(mi, off1);
+      OrdCT<NI1> off2 = getOff(as.aset_());
+      MultiInterval auxmi1 = applyOff(as.aset_(), off2);
+      // Walk both sides by position when their steps don't go along
+      bool bypos1 = !stepsDivide(mirange1, auxmi1);
+      MultiInterval loop1 = bypos1 ? counter(mirange1) : mirange1;
       itnms = nms.begin();
       // Range of ForEq
-      foreach_(Interval i, mirange1.inters_()){
+      foreach_(Interval i, loop1.inters_()){
         Expression elo(i.lo_());
         Expression est(i.step_());
         Expression ehi(i.hi_());
@@ -699,18 +778,15 @@ void Connectors::generateCode(PWLMap pw){
 
       Set sauxi;
       sauxi.addAtomSet(auxi);
-      vector<Name> effvars = get<0>(p);
       vector<Pair<Name, Name>> vars1 = getVars(effvars, sauxi);
       vector<Pair<Name, Name>>::iterator itv1 = vars1.begin();
 
       vector<Pair<Name, Name>> vars2 = getVars(effvars, auxs);
       vector<Pair<Name, Name>>::iterator itv2 = vars2.begin();
 
-      itnms = nms.begin();
-      OrdCT<NI1> off2 = getOff(as.aset_());
-      MultiInterval auxmi1 = applyOff(as.aset_(), off2);
-      Pair<ExpList, bool> tm1 = transMulti(mirange1, auxmi1, nms, false);
+      Pair<ExpList, bool> tm1 = transMulti(loop1, auxmi1, nms, false);
       ExpList inds1 = get<0>(tm1);
+      ExpList inds0 = bypos1 ? get<0>(transMulti(loop1, mirange1, nms, false)) : nms;
 
       for(; itv1 != vars1.end(); ++itv1){
         for(; itv2 != vars2.end(); ++itv2){
@@ -727,7 +803,7 @@ void Connectors::generateCode(PWLMap pw){
               ERROR("Should be a vertex");
 
             if(mivar1.size() != 1)
-              auxnms1 = nms;
+              auxnms1 = inds0;
 
             Reference ref1(get<0>(*itv1) + "_" + get<1>(*itv1), auxnms1); // Left of equality
             Expression l(ref1);
@@ -755,9 +831,7 @@ void Connectors::generateCode(PWLMap pw){
             auxeqlist1.insert(auxeqlist1.begin(), eq1);
 
             ForEq feq1(range1, auxeqlist1);
-
-            itres = res.insert(itres, feq1);
-            ++itres;
+            res.push_back(feq1);
           }
         }
       }
@@ -768,8 +842,14 @@ void Connectors::generateCode(PWLMap pw){
     itnms = nms.begin();
     OrdCT<NI1> off3 = getOff(as.aset_());
     MultiInterval mirange2 = applyOff(as.aset_(), off3); 
+    MultiInterval loop2 = mirange2;
+    foreach_(AtomSet auxi, vcdomi.asets_()){
+      OrdCT<NI1> off4 = getOff(auxi.aset_());
+      if(!stepsDivide(mirange2, applyOff(auxi.aset_(), off4)))
+        loop2 = counter(mirange2);
+    }
     //Range of ForEq of flow vars
-    foreach_(Interval i, mirange2.inters_()){
+    foreach_(Interval i, loop2.inters_()){
       Expression elo(i.lo_());
       Expression est(i.step_());
       Expression ehi(i.hi_());
@@ -785,8 +865,6 @@ void Connectors::generateCode(PWLMap pw){
     }
     Indexes range2(ran2);
 
-    vector<Name> flowvars = get<1>(p);
-
     ExpList exps;
     ExpList::iterator itexps = exps.begin();
 
@@ -796,7 +874,7 @@ void Connectors::generateCode(PWLMap pw){
 
       OrdCT<NI1> off4 = getOff(auxi.aset_());
       MultiInterval auxmi2 = applyOff(auxi.aset_(), off4); 
-      Pair<ExpList, bool> tm2 = transMulti(mirange2, auxmi2, nms, true);
+      Pair<ExpList, bool> tm2 = transMulti(loop2, auxmi2, nms, true);
       ExpList inds2 = get<0>(tm2);
 
       Set sauxi;
@@ -857,9 +935,7 @@ void Connectors::generateCode(PWLMap pw){
     auxeqlist2.insert(auxeqlist2.begin(), eq2);
 
     ForEq feq2(range2, auxeqlist2);
-
-    itres = res.insert(itres, feq2);
-    ++itres;
+    res.push_back(feq2);
   }    
 
   EquationSection eqres(false, res);
@@ -902,11 +978,11 @@ Pair<vector<Name>, vector<Name>> Connectors::separateVars(){
 } 
 
 bool Connectors::isFlowVar(Name n){
-  Option<VarInfo> ovi = mmoclass_.syms_ref()[n];
+  const VarInfo *ovi = mmoclass_.syms_ref().lookup(n);
   if(ovi){
-    VarInfo vi = *ovi;
-    TypePrefixes::iterator ittp = vi.prefixes_ref().begin(); 
-    for(; ittp != vi.prefixes_ref().end(); ++ittp){
+    const VarInfo &vi = *ovi;
+    TypePrefixes::const_iterator ittp = vi.prefixes_.begin(); 
+    for(; ittp != vi.prefixes_.end(); ++ittp){
       Option<TypePrefix> otp = *ittp;
       if(otp){
         TypePrefix tp = *otp;
@@ -1045,6 +1121,40 @@ MultiInterval Connectors::applyOff(MultiInterval mi, OrdCT<NI1> off){
   return mires;
 }
 
+// Whether transMulti can write each subscript of mi as m*i+h, i walking range.
+// Only then is the gain m = step of mi / step of range a whole number.
+bool Connectors::stepsDivide(MultiInterval range, MultiInterval mi){
+  OrdCT<Interval> ints = mi.inters_();
+  OrdCT<Interval>::iterator itints = ints.begin();
+
+  if(range.ndim_() == mi.ndim_()){
+    foreach_(Interval i, range.inters_()){
+      if(i.size() == (*itints).size() && (*itints).step_() % i.step_() != 0)
+        return false;
+
+      ++itints;
+    }
+  }
+
+  return true;
+}
+
+// 1:size of each interval of mi, to walk mi by position
+MultiInterval Connectors::counter(MultiInterval mi){
+  OrdCT<Interval> res;
+  OrdCT<Interval>::iterator itres = res.begin();
+
+  foreach_(Interval i, mi.inters_()){
+    Interval iaux(1, 1, i.size());
+
+    itres = res.insert(itres, iaux);
+    ++itres;
+  }
+
+  MultiInterval mires(res);
+  return mires;
+}
+
 /*
 ExpList Connectors::lmToExpList(LMap lm, ExpList nms){
   ExpList res;
@@ -50,20 +50,33 @@ struct NameVertexTable : public SymbolTable<Name, MultiInterval>{
   NameVertexTable(){}
 };
 
+/// How a connect subscript walks its dimension: along a for index, maybe
+/// backwards, along a slice, or not at all when it is constant
+struct SubscriptWalk{
+  SubscriptWalk() : reversed(false), slice(false){}
+  Option<Name> index;
+  bool reversed;
+  bool slice;
+};
+
 class Connectors{
   public:
   Connectors(MMO_Class &c);
 
   void debug(std::string filename);
 
-  void solve();
-  void createGraph(EquationList &eqs);
-  void connect(Connect co);
+  /// Generates the connect equations and prints the flat class to stdout,
+  /// its big equation sections on up to jobs threads
+  void solve(int jobs = 1);
+  void createGraph(EquationList &eqs, const VarSymbolTable &syms);
+  void connect(Connect co, const VarSymbolTable &syms);
   Pair<Name, ExpOptList> separate(Expression e);
   MultiInterval createVertex(Name n);
-  bool checkRanges(ExpOptList range1, ExpOptList range2);
+  MultiInterval connectRange(Name n, ExpOptList range, const VarSymbolTable &syms, vector<SubscriptWalk> &walks);
+  void checkRanges(const vector<SubscriptWalk> &walk1, const vector<SubscriptWalk> &walk2);
   Option<SetEdgeDesc> existsEdge(SetVertexDesc d1, SetVertexDesc d2);
   void updateGraph(SetVertexDesc d1, SetVertexDesc d2, MultiInterval mi1, MultiInterval mi2);
+  vector<Set> preImages(PWLMap pw, vector<AtomSet> &atoms);
   void generateCode(PWLMap pw);
   OrdCT<NI1> getOff(MultiInterval mi);
   Pair<vector<Name>, vector<Name>> separateVars();
@@ -71,8 +84,16 @@ class Connectors{
   vector<Pair<Name, Name>> getVars(vector<Name> vs, Set sauxi);
   Pair<ExpList, bool> transMulti(MultiInterval mi1, MultiInterval mi2, ExpList nms, bool forFlow);
   MultiInterval applyOff(MultiInterval mi, OrdCT<NI1> off);
+  bool stepsDivide(MultiInterval range, MultiInterval mi);
+  MultiInterval counter(MultiInterval mi);
   //ExpList lmToExpList(LMap lm, ExpList vs);
 
+  /// Seconds spent by solve building the graph, finding its connected
+  /// components and generating the equations
+  member_(double, graphTime);
+  member_(double, componentsTime);
+  member_(double, codeTime);
+
   private:
   SBGraph G;
   member_(vector<NI1>, vCount);
@@ -81,6 +102,8 @@ class Connectors{
   member_(MMO_Class, mmoclass);
   member_(VertexNameTable, vnmtable);
   member_(NameVertexTable, nmvtable);
+  /// For indexes in scope of the equation being visited
+  member_(vector<Name>, forIndexes);
 };
 
 #endif
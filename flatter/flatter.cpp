@@ -22,15 +22,17 @@
 #include <util/ast_visitors/partial_eval_expression.h>
 #include <boost/algorithm/string.hpp>
 #include <util/debug.h>
+#include <util/thread_pool.h>
 
 #include <iostream>
 using namespace std;
 
-Flatter::Flatter() {}
+Flatter::Flatter(int jobs) : _jobs(jobs), _label(0) {}
+
+const ClassFinder &Flatter::classFinder() const { return re; }
 
 void Flatter::removeConnectorVar(MMO_Class &c)
 {
-  ClassFinder re = ClassFinder();
   VarSymbolTable &vsd = c.syms_ref();
   IdentList vars = c.variables();
   c.set_variables(IdentList());
@@ -47,12 +49,74 @@ void Flatter::removeConnectorVar(MMO_Class &c)
   }
 }
 
-void Flatter::Flat(MMO_Class &c, bool flatConnector, bool initial)
+namespace {
+/// @brief Declares the flattened connector n of type t in c
+void addConnector(MMO_Class &c, Name n, VarInfo v, const Type::Type &t)
 {
-  ClassFinder re = ClassFinder();
-  Remove_Composition rc = Remove_Composition();
-  re.ExpandAll(c);
+  c.variables_ref().push_back(n);
+  Name newType = boost::algorithm::replace_all_copy(v.type(), ".", "_");
+  c.types_ref().push_back(newType);
+  c.tyTable_ref().insert(newType, t);
+  v.set_type(newType);
+  c.syms_ref().insert(n, v);
+}
+
+/// @brief Declares n in c with the builtin type that td resolves to
+void addBuiltin(MMO_Class &c, Name n, VarInfo v, const typeDefinition &td)
+{
+  const Type::Type &t_final = get<1>(td);
+  v.set_prefixes(v.prefixes() + get<0>(td));
+  if (is<Type::String>(t_final)) v.set_type("String");
+  if (is<Type::Integer>(t_final)) v.set_type("Integer");
+  if (is<Type::Real>(t_final)) v.set_type("Real");
+  if (is<Type::Boolean>(t_final)) v.set_type("Boolean");
+  c.syms_ref().insert(n, v);
+  c.variables_ref().push_back(n);
+}
+
+/// @brief Appends what LevelUp left in part to c
+void merge(MMO_Class &c, MMO_Class &part)
+{
+  foreach_(Name n, part.variables())
+  {
+    c.syms_ref().insert(n, *part.syms_ref().lookup(n));
+    c.variables_ref().push_back(n);
+  }
+  foreach_(Name n, part.types())
+  {
+    c.types_ref().push_back(n);
+    c.tyTable_ref().insert(n, part.tyTable_ref()[n].get());
+  }
+  foreach_(Equation eq, part.equations_ref().equations()) c.addEquation(eq);
+  foreach_(Equation eq, part.initial_eqs_ref().equations()) c.addInitEquation(eq);
+  foreach_(Statement st, part.statements_ref().statements()) c.addStatement(st);
+  foreach_(Statement st, part.initial_sts_ref().statements()) c.addInitStatement(st);
+}
 
+/// A variable of the class being flattened, with its resolved type and,
+/// for class instances, the flattened instance waiting to be merged
+struct FlatComponent {
+  Name name;
+  VarInfo info;
+  typeDefinition td;
+  MMO_Class down;
+  MMO_Class part;
+};
+}  // namespace
+
+MMO_Class &Flatter::flatTemplate(MMO_Class *clase, bool flatConnector)
+{
+  TemplateKey key(clase, flatConnector);
+  TemplateMap::iterator it = _templates.find(key);
+  if (it != _templates.end()) return it->second;
+  it = _templates.insert(std::make_pair(key, *clase)).first;
+  Flat(it->second, flatConnector, false);
+  return it->second;
+}
+
+void Flatter::flatComponents(MMO_Class &c, bool flatConnector)
+{
+  Remove_Composition rc = Remove_Composition(_label);
   VarSymbolTable &vsd = c.syms_ref();
   IdentList vars = c.variables();
   c.set_variables(IdentList());
@@ -68,36 +132,98 @@ void Flatter::Flat(MMO_Class &c, bool flatConnector, bool initial)
       if (v.indices()) indexes += v.indices().get();
       if (indexes.size() > 0) v.set_indices(indexes);
       if (is<Type::Class>(t_final)) {
-        MMO_Class down = *(boost::get<Type::Class>(t_final).clase());
+        MMO_Class *clase = boost::get<Type::Class>(t_final).clase();
+        bool isConnector;
         // if (flatConnector || !down.isConnector()) {
-        if (v.modification()) re.applyModification(c, down, v.modification().get());
-        Flat(down, flatConnector, false);
-        rc.LevelUp(c, down, n, v);
-        if (down.isConnector()) {
-          c.variables_ref().push_back(n);
-          Type::Class tc = boost::get<Type::Class>(t_final);
-          Name newType = boost::algorithm::replace_all_copy(v.type(), ".", "_");
-          c.types_ref().push_back(newType);
-          c.tyTable_ref().insert(newType, t_final);
-          v.set_type(newType);
-          c.syms_ref().insert(n, v);
+        if (v.modification()) {
+          MMO_Class down = *clase;
+          re.applyModification(c, down, v.modification().get());
+          Flat(down, flatConnector, false);
+          rc.LevelUp(c, down, n, v);
+          isConnector = down.isConnector();
+        } else {
+          MMO_Class &down = flatTemplate(clase, flatConnector);
+          rc.LevelUp(c, down, n, v);
+          isConnector = down.isConnector();
         }
+        if (isConnector) addConnector(c, n, v, t_final);
         //} else c.variables_ref().push_back(n);
-      } else {
-        v.set_prefixes(v.prefixes() + get<0>(td));
-        if (is<Type::String>(t_final)) v.set_type("String");
-        if (is<Type::Integer>(t_final)) v.set_type("Integer");
-        if (is<Type::Real>(t_final)) v.set_type("Real");
-        if (is<Type::Boolean>(t_final)) v.set_type("Boolean");
-        c.syms_ref().insert(n, v);
-        c.variables_ref().push_back(n);
-      }
+      } else
+        addBuiltin(c, n, v, td);
     } else {
       std::cerr << "No se pudo definir el tipo de la variable " << n << " en " << c.name() << std::endl;
-      exit(-1);
+      fatalExit(-1);
+    }
+  }
+}
+
+void Flatter::flatComponentsParallel(MMO_Class &c, bool flatConnector)
+{
+  // Types and modifications are resolved here, with the caches of this
+  // Flatter, so the workers only read the classes of the type tables
+  std::vector<FlatComponent> comps;
+  VarSymbolTable &vsd = c.syms_ref();
+  IdentList vars = c.variables();
+  c.set_variables(IdentList());
+  foreach_(Name n, vars)
+  {
+    if (!vsd[n]) continue;
+    VarInfo v = vsd[n].get();
+    OptTypeDefinition m = re.resolveType(c, v.type());
+    if (!m) {
+      std::cerr << "No se pudo definir el tipo de la variable " << n << " en " << c.name() << std::endl;
+      fatalExit(-1);
+    }
+    comps.push_back(FlatComponent());
+    FlatComponent &comp = comps.back();
+    comp.name = n;
+    comp.td = m.get();
+    ExpList indexes = get<2>(comp.td);
+    if (v.indices()) indexes += v.indices().get();
+    if (indexes.size() > 0) v.set_indices(indexes);
+    comp.info = v;
+    const Type::Type &t_final = get<1>(comp.td);
+    if (is<Type::Class>(t_final)) {
+      comp.down = *boost::get<Type::Class>(t_final).clase();
+      if (v.modification()) re.applyModification(c, comp.down, v.modification().get());
     }
   }
 
+  // Each instance is flattened by its own Flatter, so index labels are
+  // numbered per instance and the result does not depend on scheduling
+  std::vector<Flatter> workers(comps.size());
+  parallelFor(comps.size(), _jobs, [&comps, &workers, flatConnector](size_t i) {
+    FlatComponent &comp = comps[i];
+    if (!is<Type::Class>(get<1>(comp.td))) return;
+    Flatter &f = workers[i];
+    f.Flat(comp.down, flatConnector, false);
+    Remove_Composition rc = Remove_Composition(f._label);
+    rc.LevelUp(comp.part, comp.down, comp.name, comp.info);
+  });
+  // The merged types may point to classes the workers made
+  foreach_(Flatter & f, workers) re.adopt(f.re);
+
+  foreach_(FlatComponent & comp, comps)
+  {
+    const Type::Type &t_final = get<1>(comp.td);
+    if (is<Type::Class>(t_final)) {
+      merge(c, comp.part);
+      if (comp.down.isConnector()) addConnector(c, comp.name, comp.info, t_final);
+    } else
+      addBuiltin(c, comp.name, comp.info, comp.td);
+  }
+}
+
+void Flatter::Flat(MMO_Class &c, bool flatConnector, bool initial)
+{
+  re.ExpandAll(c);
+  // Only the top level is split among threads: nested levels are flattened
+  // by the worker that owns the instance
+  if (initial && _jobs > 1)
+    flatComponentsParallel(c, flatConnector);
+  else
+    flatComponents(c, flatConnector);
+
   MarkConnector mc;
   foreach_(Equation & eq, c.equations_ref().equations_ref()) eq = Apply(mc, eq);
   foreach_(Equation & eq, c.initial_eqs_ref().equations_ref()) eq = Apply(mc, eq);
@@ -32,15 +32,40 @@
 #include <util/ast_visitors/dot_expression.h>
 #include <util/ast_visitors/mark_connector.h>
 #include <boost/variant/get.hpp>
+#include <boost/unordered_map.hpp>
 
 class Flatter {
   public:
   typedef EquationVisitor<DotExpression> EqDotExpression;
   typedef StatementVisitor<DotExpression> StDotExpression;
 
-  Flatter();
+  /// @param jobs Maximum number of threads used to flatten the components
+  /// of the top level class
+  Flatter(int jobs = 1);
   void Flat(MMO_Class &c, bool flatConnector, bool initial);
   void removeConnectorVar(MMO_Class &c);
+  const ClassFinder &classFinder() const;
+
+  private:
+  typedef std::pair<const MMO_Class *, bool> TemplateKey;
+  typedef boost::unordered_map<TemplateKey, MMO_Class> TemplateMap;
+
+  /// @brief Flattened form of a component class without modifications.
+  /// It is built once per class and shared by all its instances, which
+  /// LevelUp then prefixes one by one without copying it.
+  MMO_Class &flatTemplate(MMO_Class *clase, bool flatConnector);
+  void flatComponents(MMO_Class &c, bool flatConnector);
+  /// @brief Flattens the class instances of c concurrently and merges them
+  /// back in declaration order, so the result does not depend on scheduling
+  void flatComponentsParallel(MMO_Class &c, bool flatConnector);
+
+  /// Shared by the recursive calls of Flat, so its type resolution cache is too
+  ClassFinder re;
+  /// Keyed by the type table class, which is never modified once stored
+  TemplateMap _templates;
+  int _jobs;
+  /// Next for index label of the array instances flattened here
+  int _label;
 };
 
 #endif
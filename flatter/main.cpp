@@ -43,9 +43,11 @@ int main(int argc, char** argv){
   char *className = NULL, *filename = NULL;
   char opt;
   int debug = 0;
+  int jobs = 1;
+  bool parallelFlat = false;
   std::ofstream outputFile;
 
-  while ((opt = getopt(argc, argv, "i:c:g:d")) != -1) {
+  while ((opt = getopt(argc, argv, "i:c:g:dj:p")) != -1) {
     switch (opt) {
     case 'g':
       filename = optarg;
@@ -55,28 +57,43 @@ int main(int argc, char** argv){
     case 'c':
       className = optarg;
       break;
+    case 'j':
+      jobs = atoi(optarg);
+      if (jobs < 1) {
+        std::cerr << "command-line option j expects a positive number of threads" << std::endl;
+        return -1;
+      }
+      break;
+    case 'p':
+      parallelFlat = true;
+      break;
     }
   }
 
-  StoredDef sd;
-  if (argv[optind] != NULL)
-    sd = Parser::ParseFile(argv[optind], ret);
-  else
-    sd = Parser::ParseFile("", ret);
+  // Several files, such as the pieces of a package directory, are parsed in
+  // parallel and flattened as a single stored definition
+  std::vector<std::string> sources(argv + optind, argv + argc);
+  StoredDef sd = Parser::ParseFiles(sources, ret, jobs);
 
   if(ret){
     MMO_Tree mt;
     MMO_Class mmo = mt.create(sd);
 
-    Flatter f = Flatter();
-    if(className == NULL)
-      className = (char*)::className(sd.classes().back()).c_str();
+    // Flattening the top level components in parallel was never timed on
+    // more than one core, so -j alone leaves it sequential
+    Flatter f(parallelFlat ? jobs : 1);
+    // Kept to the end: the types of the class it finds point to classes it owns
+    ClassFinder re;
+    std::string lastClass;
+    if(className == NULL){
+      lastClass = ::className(sd.classes().back());
+      className = (char*)lastClass.c_str();
+    }
     
     if(className != NULL){
       if (debug) 
         std::cerr << "Searching for class " << (className ? className : "NULL") << std::endl;
 
-      ClassFinder re = ClassFinder();
       OptTypeDefinition m = re.resolveType(mmo, className);
       if(m){
         typeDefinition td = m.get();
@@ -100,14 +117,18 @@ int main(int argc, char** argv){
     }
 
     Connectors co(mmo);
-    co.solve();
+    co.solve(jobs);
     if(debug){
       std::cerr << " - - - - - - - - - - - - - - - - - - - - - - - - " << std::endl;
       co.debug(filename);
+      std::cerr << "Connect graph: " << co.graphTime() << "s, connected components: " << co.componentsTime()
+                << "s, code generation: " << co.codeTime() << "s" << std::endl;
       std::cerr << " - - - - - - - - - - - - - - - - - - - - - - - - " << std::endl;
     }
 
     f.removeConnectorVar(mmo);
+    if (debug)
+      std::cerr << "Type resolution cache: " << f.classFinder().cacheHits() << " hits, " << f.classFinder().cacheMisses() << " misses" << std::endl;
     if (debug) 
       std::cerr << "Final Result: " << endl;
     /*
@@ -21,33 +21,31 @@
 #include <flatter/remove_composition.h>
 #include <boost/variant/get.hpp>
 
-static int label;
+Remove_Composition::Remove_Composition(int &label) : _label(label) {}
 
-Name nextIndexLabel()
+Name Remove_Composition::nextIndexLabel()
 {
   stringstream ret(stringstream::out);
-  ret << "_Index_" << label++;
+  ret << "_Index_" << _label++;
   return ret.str();
 }
 
-Remove_Composition::Remove_Composition() {}
-
 void Remove_Composition::LevelUp(MMO_Class &up, MMO_Class &down, Name nUp, VarInfo viUp)
 {
   DotExpression _dot = DotExpression(Option<MMO_Class &>(down), nUp, ExpList());
   foreach_(Name n, down.variables())
   {
-    Option<VarInfo> viDown = down.syms_ref()[n];
+    const VarInfo *viDown = down.syms_ref().lookup(n);
     if (viDown) {
-      Name tDown = viDown.get().type();
+      Name tDown = viDown->type();
       Name tUp = viUp.type();
       Name newName = nUp + "_" + n;
       ExpList iexp;
       Option<ExpList> ind;
       if (viUp.indices()) iexp += viUp.indices().get();
-      if (viDown.get().indices()) iexp += viDown.get().indices().get();
+      if (viDown->indices()) iexp += viDown->indices().get();
       if (iexp.size() > 0) ind = iexp;
-      Option<Modification> opt_mod = viDown.get().modification();
+      Option<Modification> opt_mod = viDown->modification();
       if (opt_mod && viUp.indices()) {  // adjust for arrays
         Modification &mod = opt_mod.get();
         if (is<ModEq>(mod)) {
@@ -76,7 +74,7 @@ void Remove_Composition::LevelUp(MMO_Class &up, MMO_Class &down, Name nUp, VarIn
         }
       }
 
-      VarInfo v = VarInfo(viDown.get().prefixes(), tDown, viDown.get().comment(), opt_mod, ind, false);
+      VarInfo v = VarInfo(viDown->prefixes(), tDown, viDown->comment(), opt_mod, ind, false);
       //v.removePrefix(flow);
       v.removePrefix(output);
       v.removePrefix(input);
@@ -41,10 +41,14 @@ struct Remove_Composition {
   public:
   typedef EquationVisitor<DotExpression> EqDotExpression;
   typedef StatementVisitor<DotExpression> StDotExpression;
-  Remove_Composition();
+  /// @param label Counter used to name the for indexes of array instances.
+  /// Labels are unique among the classes flattened with the same counter.
+  Remove_Composition(int &label);
   void LevelUp(MMO_Class &up, MMO_Class &down, Name nUp, VarInfo viUp);
 
   private:
+  Name nextIndexLabel();
+  int &_label;
   Equation createForEquation(IdentList index, ExpList indexVar, EquationList el);
   Statement createForStatement(IdentList index, ExpList indexVar, StatementList el);
 };
@@ -25,6 +25,7 @@
 #include <util/debug.h>
 #include <util/ast_visitors/to_micro/convert_to_micro.h>
 #include <cstdlib>
+#include <unistd.h>
 
 int main(int argc, char** argv)
 {
@@ -35,9 +36,10 @@ int main(int argc, char** argv)
   using namespace boost;
   bool ret;
   int opt;
+  int jobs = 1;
   StoredDef sd;
 
-  while ((opt = getopt(argc, argv, "d")) != -1) {
+  while ((opt = getopt(argc, argv, "dj:")) != -1) {
     switch (opt) {
     case 'd':
       if (optarg != NULL && isDebugParam(optarg)) {
@@ -46,6 +48,13 @@ int main(int argc, char** argv)
         ERROR("command-line option d has no arguments\n");
       }
       break;
+    case 'j':
+      jobs = atoi(optarg);
+      if (jobs < 1) {
+        std::cerr << "command-line option j expects a positive number of threads" << std::endl;
+        return -1;
+      }
+      break;
     }
   }
 
@@ -60,7 +69,9 @@ int main(int argc, char** argv)
     MMO_Class mmo(get<Class>(sd.classes().front()));
     ConvertToMicro tm(mmo);
     tm.convert();
-    std::cout << mmo << std::endl;
+    // Large outputs are printed in chunks, straight to the descriptor
+    std::cout.flush();
+    if (!writeClass(STDOUT_FILENO, mmo, jobs)) return -1;
   } else
     std::cout << "Error parser" << std::endl;
   return 0;
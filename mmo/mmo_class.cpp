@@ -21,12 +21,15 @@
 #include <boost/variant/get.hpp>
 #include <util/debug.h>
 #include <util/ast_visitors/eval_expression.h>
+#include <util/output_buffer.h>
+#include <util/thread_pool.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace Modelica {
 MMO_Class::MMO_Class() { father_ = NULL; }
-MMO_Class::MMO_Class(Class &c) : variables_()
+MMO_Class::MMO_Class(const Class &c) : variables_()
 {
   using namespace boost;
 
@@ -94,44 +97,72 @@ MMO_Class::MMO_Class(Class &c) : variables_()
   }
 }
 
-std::ostream &operator<<(std::ostream &out, const MMO_Class &c)
+namespace {
+/// @brief Equation sections longer than this are printed in chunks of this
+/// many equations, spread over the threads
+const size_t EQUATION_CHUNK = 4096;
+
+void printEquations(std::ostream &out, const EquationSection &es, int jobs)
 {
-  VarSymbolTable table = c.syms();
-  TypeSymbolTable tipos = c.tyTable();
+  const EquationList &eqs = es.equations();
+  if (jobs <= 1 || eqs.size() <= EQUATION_CHUNK) {
+    out << es;
+    return;
+  }
+  out << (es.initial() ? "initial equation\n" : "equation\n");
+  // Workers start with their own indentation and stream flags
+  long indent = depth;
+  long c_flag = printAsCActive(out);
+  size_t chunks = (eqs.size() + EQUATION_CHUNK - 1) / EQUATION_CHUNK;
+  std::vector<OutputBuffer> parts(chunks);
+  parallelFor(chunks, jobs, [&](size_t i) {
+    std::ostream chunk(&parts[i]);
+    setCFlag(chunk, c_flag);
+    depth = indent;
+    size_t from = i * EQUATION_CHUNK, to = std::min(from + EQUATION_CHUNK, eqs.size());
+    for (size_t e = from; e < to; e++) chunk << INDENT << eqs[e] << ";\n";
+  });
+  for (size_t i = 0; i < chunks; i++) out.write(parts[i].text().data(), parts[i].text().size());
+}
+
+void printClass(std::ostream &out, const MMO_Class &c, int jobs)
+{
+  const VarSymbolTable &table = c.syms();
+  const TypeSymbolTable &tipos = c.tyTable();
   foreach_(Option<ClassPrefix> cp, c.prefixes()) out << classPrefix(cp);
   out << c.name() << "\n";
   BEGIN_BLOCK;
 
-  foreach_(Import n, c.imports()) out << INDENT << n << ";\n";
+  foreach_(const Import &n, c.imports()) out << INDENT << n << ";\n";
 
-  foreach_(Extends n, c.extends()) out << INDENT << n << ";\n";
+  foreach_(const Extends &n, c.extends()) out << INDENT << n << ";\n";
 
-  foreach_(Name n, c.types())
+  foreach_(const Name &n, c.types())
   {
-    Option<Type::Type> t = tipos[n];
-    if (t) out << INDENT << (t.get()) << std::endl;
+    const Type::Type *t = tipos.lookup(n);
+    if (t) out << INDENT << *t << "\n";
   }
 
-  foreach_(Name n, c.variables())
+  foreach_(const Name &n, c.variables())
   {
-    VarInfo vinfo = table[n].get();
+    const VarInfo &vinfo = *table.lookup(n);
     out << INDENT;
     foreach_(Option<TypePrefix> tp, vinfo.prefixes()) out << typePrefix(tp);
     out << vinfo.type() << " " << n;
     if (vinfo.indices()) {
-      ExpList el = vinfo.indices().get();
+      const ExpList &el = vinfo.indices().get();
       int l = el.size(), i = 0;
       out << "[";
-      foreach_(Expression e, el) out << e << (++i < l ? ", " : "");
+      foreach_(const Expression &e, el) out << e << (++i < l ? ", " : "");
       out << "]";
     }
     if (vinfo.modification()) out << vinfo.modification().get();
     out << ";\n";
   }
 
-  out << c.initial_eqs();
+  printEquations(out, c.initial_eqs(), jobs);
   out << c.initial_sts();
-  out << c.equations();
+  printEquations(out, c.equations(), jobs);
   out << c.statements();
   END_BLOCK;
   if (c.external()) {
@@ -153,9 +184,25 @@ std::ostream &operator<<(std::ostream &out, const MMO_Class &c)
   }
   if (c.annotation()) out << c.annotation().get() << ";\n";
   out << INDENT << "end " << c.name() << ";";
+}
+}  // namespace
+
+std::ostream &operator<<(std::ostream &out, const MMO_Class &c)
+{
+  printClass(out, c, 1);
   return out;
 }
 
+bool writeClass(int fd, const MMO_Class &c, int jobs)
+{
+  OutputBuffer buffer(fd);
+  std::ostream out(&buffer);
+  printClass(out, c, jobs);
+  out << "\n";
+  return buffer.flush();
+}
+
+
 member_imp(MMO_Class, std::vector<Name>, variables);
 member_imp(MMO_Class, std::vector<Name>, types);
 member_imp(MMO_Class, EquationSection, equations);
@@ -253,13 +300,20 @@ void MMO_Class::rmVar(Name n){
 
 Option<VarInfo> MMO_Class::getVar(Name n)
 {
-  Option<VarInfo> v = syms_[n];
+  const VarInfo *v = lookupVar(n);
+  if (v) return *v;
+  return Option<VarInfo>();
+}
+
+const VarInfo *MMO_Class::lookupVar(Name n) const
+{
+  const VarInfo *v = syms_.lookup(n);
   if (v)
     return v;
   else if (father_)
-    return father_->getVar(n);
+    return father_->lookupVar(n);
   else
-    return Option<VarInfo>();
+    return NULL;
 }
 
 bool MMO_Class::isLocal(Name n)
@@ -30,7 +30,7 @@ struct MMO_Class;
 
 struct MMO_Class {
   MMO_Class();
-  MMO_Class(Class &c);
+  MMO_Class(const Class &c);
   member_(Name, name);
   member_(ClassPrefixes, prefixes);
   member_(EquationSection, initial_eqs);
@@ -63,7 +63,13 @@ struct MMO_Class {
   void addVar(Name n, VarInfo var);
   void rmVar(Name n);
   Option<VarInfo> getVar(Name n);
+  const VarInfo *lookupVar(Name n) const;
   bool isLocal(Name n);
 };
+
+/// @brief Prints c as Modelica source to fd, followed by a newline. The text
+/// is buffered and written in large blocks, and big equation sections are
+/// printed in chunks on up to jobs threads. Returns false if writing failed.
+bool writeClass(int fd, const MMO_Class &c, int jobs = 1);
 }  // namespace Modelica
 #endif
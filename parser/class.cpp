@@ -22,7 +22,7 @@
 
 namespace Modelica {
 namespace Parser {
-typedef std::string::const_iterator iterator_type;
+typedef const char *iterator_type;
 template struct ClassRule<iterator_type>;
 }  // namespace Parser
 }  // namespace Modelica
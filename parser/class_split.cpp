@@ -0,0 +1,181 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <cstring>
+
+#include <parser/class_split.h>
+#include <parser/skipper.h>
+
+namespace Modelica {
+namespace Parser {
+
+namespace {
+enum TokenKind { NONE, IDENT, STRING, NUMBER, PUNCT };
+
+struct Token {
+  TokenKind kind;
+  const char *begin, *end;
+  bool is(const char *word) const
+  {
+    size_t n = strlen(word);
+    return kind == IDENT && size_t(end - begin) == n && !memcmp(begin, word, n);
+  }
+  bool is(char c) const { return kind == PUNCT && *begin == c; }
+  std::string text() const { return std::string(begin, end); }
+};
+
+const char *CLASS_KEYWORDS[] = {"class", "model", "record", "block", "connector", "type", "package", "function", "operator"};
+const char *CLASS_PREFIXES[] = {"final", "encapsulated", "partial", "expandable", "pure", "impure"};
+// Words that end the leading element list of a composition
+const char *SECTION_KEYWORDS[] = {"equation", "algorithm", "initial", "public", "protected", "external", "annotation", "end"};
+
+template <size_t N>
+bool isOneOf(const Token &t, const char *(&words)[N])
+{
+  for (size_t i = 0; i < N; i++)
+    if (t.is(words[i])) return true;
+  return false;
+}
+
+bool identStart(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+bool identChar(char c) { return identStart(c) || (c >= '0' && c <= '9'); }
+
+/// Splits the source into the tokens the grammar would see, closely enough to
+/// find brackets, semicolons and the words that open and close classes.
+/// Strings and quoted identifiers follow the grammar's own escaping rules.
+class Scanner {
+  public:
+  Scanner(const char *begin, const char *end) : next_(begin), end_(end), last_(begin) { advance(); }
+  const Token &peek() const { return token_; }
+  Token take()
+  {
+    Token t = token_;
+    last_ = t.end;
+    advance();
+    return t;
+  }
+  /// @brief End of the last token taken
+  const char *position() const { return last_; }
+
+  private:
+  void advance()
+  {
+    const char *p = skipLayout(next_, end_);
+    token_.begin = p;
+    token_.kind = NONE;
+    if (p != end_) {
+      char c = *p;
+      if (identStart(c)) {
+        while (++p != end_ && identChar(*p))
+          ;
+        token_.kind = IDENT;
+      } else if (c == '\'') {
+        while (++p != end_ && *p != '\'')
+          ;
+        if (p != end_) {
+          token_.kind = IDENT;
+          ++p;
+        }
+      } else if (c == '"') {
+        while (++p != end_ && *p != '"')
+          if (*p == '\\' && p + 1 != end_ && p[1] == '"') ++p;
+        if (p != end_) {
+          token_.kind = STRING;
+          ++p;
+        }
+      } else if (c >= '0' && c <= '9') {
+        while (++p != end_ && (identChar(*p) || *p == '.' || ((*p == '+' || *p == '-') && (p[-1] == 'e' || p[-1] == 'E'))))
+          ;
+        token_.kind = NUMBER;
+      } else {
+        ++p;
+        token_.kind = PUNCT;
+      }
+    }
+    // An unterminated string or quoted identifier reads as the end of input
+    token_.end = token_.kind == NONE ? end_ : p;
+    next_ = token_.end;
+  }
+  Token token_;
+  const char *next_, *end_, *last_;
+};
+
+/// @brief Takes the tokens of one element up to its closing semicolon
+bool takeElement(Scanner &s)
+{
+  int depth = 0;
+  // Long classes opened inside the element and not yet closed
+  std::vector<std::string> open;
+  for (;;) {
+    Token t = s.take();
+    if (t.kind == NONE) return false;
+    if (t.kind == PUNCT) {
+      if (strchr("([{", *t.begin)) {
+        depth++;
+      } else if (strchr(")]}", *t.begin)) {
+        if (--depth < 0) return false;
+      } else if (*t.begin == ';' && depth == 0 && open.empty()) {
+        return true;
+      }
+    } else if (depth == 0 && t.is("end")) {
+      if (!open.empty() && s.peek().kind == IDENT && s.peek().text() == open.back()) {
+        s.take();
+        open.pop_back();
+      }
+    } else if (depth == 0 && isOneOf(t, CLASS_KEYWORDS)) {
+      while (isOneOf(s.peek(), CLASS_KEYWORDS)) s.take();
+      if (s.peek().is("extends")) s.take();
+      if (s.peek().kind != IDENT) continue;
+      Token name = s.take();
+      // Short class definitions end at the element's semicolon
+      if (!s.peek().is('=') && !s.peek().is('(')) open.push_back(name.text());
+    }
+  }
+}
+}  // namespace
+
+bool splitElements(const char *begin, const char *end, ElementSplit &split)
+{
+  Scanner s(begin, end);
+  if (s.peek().is("within")) {
+    while (s.peek().kind != NONE && !s.peek().is(';')) s.take();
+    if (s.take().kind == NONE) return false;
+  }
+  while (isOneOf(s.peek(), CLASS_PREFIXES)) s.take();
+  if (!isOneOf(s.peek(), CLASS_KEYWORDS)) return false;
+  while (isOneOf(s.peek(), CLASS_KEYWORDS)) s.take();
+  Token name = s.take();
+  if (name.kind != IDENT || name.is("extends") || s.peek().is('=')) return false;
+  while (s.peek().kind == STRING || s.peek().is('+')) s.take();
+
+  const char *elements = s.position();
+  const char *from = elements;
+  split.elements.clear();
+  while (!(s.peek().kind == IDENT && isOneOf(s.peek(), SECTION_KEYWORDS))) {
+    if (!takeElement(s)) return false;
+    split.elements.push_back(TextSpan(from, s.position()));
+    from = s.position();
+  }
+  split.skeleton.assign(begin, elements);
+  split.skeleton.append(from, end);
+  return !split.elements.empty();
+}
+
+}  // namespace Parser
+}  // namespace Modelica
@@ -0,0 +1,53 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#ifndef CLASS_SPLIT
+#define CLASS_SPLIT
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Modelica {
+namespace Parser {
+
+typedef std::pair<const char *, const char *> TextSpan;
+
+/**
+ * The source of a stored definition cut at element boundaries of its first
+ * class, found with a token scan instead of the grammar. Parsing every
+ * element span with the element_list rule and the skeleton with the
+ * stored_definition rule, then putting the elements in front of the first
+ * class' element list, gives the same tree as parsing the whole source.
+ */
+struct ElementSplit {
+  /// @brief The source with the leading element list of the first class cut out
+  std::string skeleton;
+  /// @brief One span per element, from the end of the previous one up to and
+  /// including its closing semicolon
+  std::vector<TextSpan> elements;
+};
+
+/// @brief Splits [begin, end). Returns false if the first class is not a long
+/// class definition or the scan finds something it does not understand; the
+/// source must then be parsed as a whole.
+bool splitElements(const char *begin, const char *end, ElementSplit &split);
+
+}  // namespace Parser
+}  // namespace Modelica
+#endif
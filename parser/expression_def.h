@@ -44,6 +44,7 @@ Expression range2(Expression a, Expression b)
   return Range(r.start(), r.end(), b);
 }
 ExpList create_for(Expression e, Indexes i) { return ExpList(1, ForExp(e, i)); }
+ExpList for_arguments(ExpList args, Indexes i) { return create_for(args.front(), i); }
 
 struct or_op_ : qi::symbols<char, BinOpType> {
   or_op_() { add("or", Or); }
@@ -174,11 +175,12 @@ ExpressionRule<Iterator>::ExpressionRule(Iterator &it)
   function_call_args = OPAREN > (-function_arguments) > CPAREN;
 
   // TODO: forexp is missing
+  // The argument is parsed once and what follows it decides the shape of the
+  // list; trying each shape from scratch made nested calls exponential
   function_arguments = named_arguments[_val = _1] |
                        (function_argument[_val = bind(&consume_one<Expression>, _1)] >>
-                        (COMA > function_arguments[_val = bind(&append_list<Expression>, _val, _1)])) |
-                       ((function_argument >> FOR > for_indices)[_val = bind(&create_for, _1, _2)]) |
-                       function_argument[_val = bind(&consume_one<Expression>, _1)];
+                        -((COMA > function_arguments[_val = bind(&append_list<Expression>, _val, _1)]) |
+                          (FOR > for_indices[_val = bind(&for_arguments, _val, _1)])));
 
   for_indices = (for_index % COMA)[_val = construct<Indexes>(_1)];
 
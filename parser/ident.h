@@ -28,7 +28,7 @@ namespace Parser {
 template <typename Iterator>
 struct IdentRule : qi::grammar<Iterator, Name()> {
   IdentRule(Iterator &it);
-  qi::rule<Iterator, Name()> ident, keyword_ident;
+  qi::rule<Iterator, Name()> ident;
 };
 }  // namespace Parser
 }  // namespace Modelica
@@ -45,21 +45,72 @@ struct Keywords : qi::symbols<char, std::string> {
   }
 } keywords;
 
+/// @brief Terminal matching an unquoted identifier
+BOOST_SPIRIT_TERMINAL(plain_ident)
+
+inline bool isIdentStart(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+inline bool isIdentChar(char c) { return isIdentStart(c) || (c >= '0' && c <= '9'); }
+
+/// Hand written scanner behind plain_ident: takes the longest run of
+/// identifier characters and rejects it only if it is exactly a keyword, so
+/// words that merely start with one (endTime, inner1) are identifiers.
+struct PlainIdentParser : qi::primitive_parser<PlainIdentParser> {
+  template <typename Context, typename Iterator>
+  struct attribute {
+    typedef std::string type;
+  };
+
+  template <typename Iterator, typename Context, typename Skip, typename Attribute>
+  bool parse(Iterator &first, Iterator const &last, Context &, Skip const &skipper, Attribute &attr) const
+  {
+    qi::skip_over(first, last, skipper);
+    if (first == last || !isIdentStart(*first)) return false;
+    Iterator end = first;
+    while (++end != last && isIdentChar(*end))
+      ;
+    std::string word(first, end);
+    if (keywords.find(word)) return false;
+    boost::spirit::traits::assign_to(word, attr);
+    first = end;
+    return true;
+  }
+
+  template <typename Context>
+  boost::spirit::info what(Context &) const
+  {
+    return boost::spirit::info("identifier");
+  }
+};
+}  // namespace Parser
+}  // namespace Modelica
+
+namespace boost {
+namespace spirit {
+template <>
+struct use_terminal<qi::domain, Modelica::Parser::tag::plain_ident> : mpl::true_ {
+};
+namespace qi {
+template <typename Modifiers>
+struct make_primitive<Modelica::Parser::tag::plain_ident, Modifiers> {
+  typedef Modelica::Parser::PlainIdentParser result_type;
+  result_type operator()(unused_type, unused_type) const { return result_type(); }
+};
+}  // namespace qi
+}  // namespace spirit
+}  // namespace boost
+
+namespace Modelica {
+namespace Parser {
 template <typename Iterator>
 IdentRule<Iterator>::IdentRule(Iterator &it) : IdentRule::base_type(ident)
 {
   using qi::alnum;
-  using qi::alpha;
   using qi::char_;
   using qi::lexeme;
 
-  keyword_ident = keywords >> +(alnum | char_('_'));
-
-  ident = lexeme[((char_('_') | alpha) >> *(alnum | char_('_'))) - keywords] | lexeme[keyword_ident] |
-          lexeme[char_('\'') >> *(alnum | char_('_') | quoted_chars) > char_('\'')];
+  ident = lexeme[plain_ident] | lexeme[char_('\'') >> *(alnum | char_('_') | quoted_chars) > char_('\'')];
 
   ident.name("identifier");
-  keyword_ident.name("identifier");
 }
 }  // namespace Parser
 }  // namespace Modelica
@@ -17,67 +17,248 @@
 
 ******************************************************************************/
 
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <streambuf>
+#include <iterator>
+#include <vector>
 #include <boost/fusion/include/std_pair.hpp>
 #include <boost/fusion/include/boost_tuple.hpp>
-#include <boost/spirit/include/support_istream_iterator.hpp>
 
+#include <ast/serialize.h>
 #include <util/debug.h>
+#include <util/thread_pool.h>
 #include <parser/parser.h>
 #include <parser/class.h>
+#include <parser/class_split.h>
 #include <parser/skipper.h>
 
 using namespace std;
 namespace Modelica {
 namespace Parser {
-typedef std::string::const_iterator iterator_type;
+typedef const char *iterator_type;
 typedef Skipper<iterator_type> space_type;
 
+namespace {
+/// @brief The bytes of an input: mapped read-only when it is a regular file,
+/// read into a single growing buffer otherwise (stdin, pipes).
+class Source {
+  public:
+  Source() : map_(NULL), size_(0) {}
+  ~Source()
+  {
+    if (map_) munmap(map_, size_);
+  }
+  /// @brief Maps or reads the whole of fd, which may be closed afterwards
+  bool load(int fd);
+  const char *begin() const { return map_ ? static_cast<const char *>(map_) : buffer_.data(); }
+  const char *end() const { return begin() + size(); }
+  size_t size() const { return map_ ? size_ : buffer_.size(); }
+
+  private:
+  Source(const Source &);
+  Source &operator=(const Source &);
+  void *map_;
+  size_t size_;
+  std::vector<char> buffer_;
+};
+
+bool Source::load(int fd)
+{
+  struct stat st;
+  bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+  if (regular && st.st_size > 0) {
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      map_ = map;
+      size_ = st.st_size;
+      return true;
+    }
+  }
+  size_t used = 0;
+  buffer_.resize(regular && st.st_size > 0 ? st.st_size : 64 * 1024);
+  for (;;) {
+    if (used == buffer_.size()) buffer_.resize(2 * buffer_.size());
+    ssize_t n = read(fd, &buffer_[used], buffer_.size() - used);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) return false;
+    if (n == 0) break;
+    used += n;
+  }
+  buffer_.resize(used);
+  return true;
+}
+
+/// @brief Directory holding cached ASTs, or NULL when the cache is disabled
+const char *cacheDirectory()
+{
+  const char *dir = getenv("MODELICACC_CACHE");
+  return dir && *dir ? dir : NULL;
+}
+
+/// @brief Cached trees are named after the FNV-1a hash and size of their text
+std::string cachePath(const char *dir, const char *begin, const char *end, const char *extension)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char *c = begin; c != end; c++) {
+    hash ^= static_cast<unsigned char>(*c);
+    hash *= 1099511628211ULL;
+  }
+  char file[64];
+  snprintf(file, sizeof(file), "%016llx-%zx.%s", static_cast<unsigned long long>(hash), size_t(end - begin), extension);
+  return std::string(dir) + "/" + file;
+}
+
+template <typename Node>
+bool loadCached(const std::string &path, Node &node)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  Source image;
+  bool loaded = image.load(fd) && AST::deserialize(image.begin(), image.size(), node);
+  close(fd);
+  return loaded;
+}
+
+/// @brief Writes the image under a private name and renames it into place, so
+/// concurrent tools never see a partial file. The name is private to the
+/// process and to the call, as threads of one process may store the same
+/// image at once. Failures only lose the cache.
+template <typename Node>
+void storeCached(const char *dir, const std::string &path, const Node &node)
+{
+  static std::atomic<unsigned long> stores(0);
+  std::string image;
+  AST::serialize(node, image);
+  mkdir(dir, 0777);
+  std::string tmp = path + "." + std::to_string(getpid()) + "." + std::to_string(stores++);
+  std::ofstream out(tmp.c_str(), std::ios::binary);
+  out.write(image.data(), image.size());
+  out.close();
+  if (!out || rename(tmp.c_str(), path.c_str())) unlink(tmp.c_str());
+}
+
+/// @brief The grammars are expensive to build and keep no state between
+/// parses, so every thread builds each of them once and reuses it. The
+/// iterator a grammar is constructed with is never read.
+template <typename Grammar>
+Grammar &grammar()
+{
+  static thread_local iterator_type unused = NULL;
+  static thread_local Grammar g(unused);
+  return g;
+}
+
+template <typename Node, typename Rule>
+bool parseText(iterator_type begin, iterator_type end, const Rule &rule, Node &node)
+{
+  bool r = phrase_parse(begin, end, rule, space_type(), node);
+  return r && begin == end;
+}
+
+/// @brief Parses source one element of its first class at a time, taking the
+/// tree of every element whose text is already cached from the cache, so an
+/// edit to one class of a large package only parses that class again.
+bool parseIncremental(const char *dir, const Source &source, AST::StoredDef &sd)
+{
+  ElementSplit split;
+  if (!splitElements(source.begin(), source.end(), split)) return false;
+  ClassRule<iterator_type> &rules = grammar<ClassRule<iterator_type>>();
+  AST::ElemList elements;
+  foreach_(const TextSpan &span, split.elements)
+  {
+    std::string path = cachePath(dir, span.first, span.second, "elem");
+    AST::ElemList part;
+    if (!loadCached(path, part)) {
+      if (!parseText(span.first, span.second, rules.element_list, part)) return false;
+      storeCached(dir, path, part);
+    }
+    elements.insert(elements.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+  }
+  const char *skeleton = split.skeleton.data();
+  if (!parseText(skeleton, skeleton + split.skeleton.size(), rules.stored_definition, sd)) return false;
+  if (sd.classes().empty() || !is<AST::Class>(sd.classes().front())) return false;
+  AST::ElemList &first = boost::get<AST::Class>(sd.classes_ref().front()).composition_ref().elements_ref();
+  elements.insert(elements.end(), std::make_move_iterator(first.begin()), std::make_move_iterator(first.end()));
+  first.swap(elements);
+  return true;
+}
+}  // namespace
+
 AST::StoredDef ParseFile(std::string name, bool &r)
 {
-  std::string str, res;
+  Source source;
   AST::StoredDef sd;
 
   if (name != "") {
-    std::ifstream in(name.c_str());
-    if (in.fail()) {
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
       std::cerr << "Unable to open file " << name << endl;
-      exit(-1);
+      fatalExit(-1);
     }
-    in.unsetf(std::ios::skipws);
-    std::string res((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
-    std::string::const_iterator iter = res.begin();
-    std::string::const_iterator end = res.end();
-    Modelica::Parser::ClassRule<iterator_type> p(iter);
-    r = phrase_parse(iter, end, p.stored_definition, space_type(), sd);
-    if (r && iter == end) return sd;
-    r = false;
-    return AST::StoredDef();
-  } else {
-    while (std::getline(std::cin, str)) {
-      str += "\n";
-      res.append(str);
+    bool loaded = source.load(fd);
+    close(fd);
+    if (!loaded) {
+      std::cerr << "Unable to read file " << name << endl;
+      fatalExit(-1);
     }
-    std::string::const_iterator iter = res.begin();
-    std::string::const_iterator end = res.end();
-    Modelica::Parser::ClassRule<iterator_type> p(iter);
-    r = phrase_parse(iter, end, p.stored_definition, space_type(), sd);
-    if (r && iter == end) {
+  } else if (!source.load(STDIN_FILENO)) {
+    std::cerr << "Unable to read standard input" << endl;
+    fatalExit(-1);
+  }
+  const char *dir = cacheDirectory();
+  std::string cached;
+  if (dir) {
+    cached = cachePath(dir, source.begin(), source.end(), "ast");
+    if (loadCached(cached, sd)) {
+      r = true;
       return sd;
     }
-    r = false;
-    return AST::StoredDef();
   }
+  r = dir && parseIncremental(dir, source, sd);
+  if (!r) {
+    sd = AST::StoredDef();
+    r = parseText(source.begin(), source.end(), grammar<ClassRule<iterator_type>>().stored_definition, sd);
+  }
+  if (!r) return AST::StoredDef();
+  if (dir) storeCached(dir, cached, sd);
+  return sd;
+}
+
+AST::StoredDef ParseFiles(const std::vector<std::string> &names, bool &r, int jobs)
+{
+  if (names.empty()) return ParseFile("", r);
+  std::vector<AST::StoredDef> parts(names.size());
+  std::vector<char> parsed(names.size());
+  parallelFor(names.size(), jobs, [&](size_t i) {
+    bool ok;
+    parts[i] = ParseFile(names[i], ok);
+    parsed[i] = ok;
+  });
+  AST::StoredDef sd = std::move(parts.front());
+  r = parsed.front();
+  for (size_t i = 1; i < parts.size(); i++) {
+    AST::ClassList &classes = parts[i].classes_ref();
+    sd.classes_ref().insert(sd.classes_ref().end(), std::make_move_iterator(classes.begin()), std::make_move_iterator(classes.end()));
+    r = r && parsed[i];
+  }
+  if (!r) return AST::StoredDef();
+  return sd;
 }
 
 AST::Expression ParseExpression(std::string exp, bool &r)
 {
-  std::string::const_iterator iter = exp.begin();
-  std::string::const_iterator end = exp.end();
+  iterator_type iter = exp.data();
+  iterator_type end = iter + exp.size();
   AST::Expression e;
-  Modelica::Parser::ExpressionRule<iterator_type> p(iter);
-  r = phrase_parse(iter, end, p.expression, space_type(), e);
+  r = phrase_parse(iter, end, grammar<ExpressionRule<iterator_type>>().expression, space_type(), e);
   if (r && iter == end) {
     return e;
   }
@@ -18,11 +18,21 @@
 ******************************************************************************/
 
 #include <string>
+#include <vector>
 #include <ast/class.h>
 
 namespace Modelica {
 namespace Parser {
+/// @brief Parses name, or stdin when name is empty. If MODELICACC_CACHE names a
+/// directory, ASTs are cached there keyed by the hash of the source text and
+/// loaded back instead of running the grammar when the same text is parsed
+/// again. The elements of the first class are also cached one by one, so after
+/// an edit only the classes whose text changed are parsed again.
 AST::StoredDef ParseFile(std::string name, bool &r);
+/// @brief Parses every file, on up to jobs threads, into one stored definition
+/// holding all their classes in the order given. Its name and within clause
+/// come from the first file. With no names it parses stdin.
+AST::StoredDef ParseFiles(const std::vector<std::string> &names, bool &r, int jobs = 1);
 AST::Expression ParseExpression(std::string exp, bool &r);
 }  // namespace Parser
 }  // namespace Modelica
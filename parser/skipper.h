@@ -20,22 +20,90 @@
 #ifndef SKIPPER_PARSER
 #define SKIPPER_PARSER
 
+#include <algorithm>
+#include <boost/spirit/include/qi.hpp>
+
 namespace Modelica {
 namespace Parser {
 namespace qi = boost::spirit::qi;
 namespace ascii = boost::spirit::ascii;
+
+/// @brief Terminal matching a whole run of blanks and comments at once
+BOOST_SPIRIT_TERMINAL(layout)
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+/// @brief End of the run of blanks, // comments and /* */ comments starting at
+/// first. A comment missing its terminator is not layout.
 template <typename Iterator>
-struct Skipper : qi::grammar<Iterator> {
-  Skipper() : Skipper::base_type(start)
+Iterator skipLayout(Iterator first, Iterator const &last)
+{
+  static const char END_COMMENT[] = {'*', '/'};
+  for (;;) {
+    while (first != last && isBlank(*first)) ++first;
+    if (first == last || *first != '/') return first;
+    Iterator next = first;
+    if (++next == last) return first;
+    if (*next == '/') {
+      Iterator eol = std::find(++next, last, '\n');
+      if (eol == last) return first;
+      first = ++eol;
+    } else if (*next == '*') {
+      Iterator end = std::search(++next, last, END_COMMENT, END_COMMENT + 2);
+      if (end == last) return first;
+      first = end + 2;
+    } else {
+      return first;
+    }
+  }
+}
+
+/// Hand written scanner behind layout. Skipping runs it once per gap between
+/// tokens instead of once per blank or comment character.
+struct LayoutParser : qi::primitive_parser<LayoutParser> {
+  template <typename Context, typename Iterator>
+  struct attribute {
+    typedef boost::spirit::unused_type type;
+  };
+
+  template <typename Iterator, typename Context, typename Skip, typename Attribute>
+  bool parse(Iterator &first, Iterator const &last, Context &, Skip const &, Attribute &) const
   {
-    using qi::char_;
-    ascii::space_type space;
+    Iterator end = skipLayout(first, last);
+    if (end == first) return false;
+    first = end;
+    return true;
+  }
 
-    start = space                              // tab/space/cr/lf
-            | "//" >> *(char_ - "\n") >> "\n"  // C++-style comments
-            | "/*" >> *(char_ - "*/") >> "*/"  // C-style comments
-        ;
+  template <typename Context>
+  boost::spirit::info what(Context &) const
+  {
+    return boost::spirit::info("layout");
   }
+};
+}  // namespace Parser
+}  // namespace Modelica
+
+namespace boost {
+namespace spirit {
+template <>
+struct use_terminal<qi::domain, Modelica::Parser::tag::layout> : mpl::true_ {
+};
+namespace qi {
+template <typename Modifiers>
+struct make_primitive<Modelica::Parser::tag::layout, Modifiers> {
+  typedef Modelica::Parser::LayoutParser result_type;
+  result_type operator()(unused_type, unused_type) const { return result_type(); }
+};
+}  // namespace qi
+}  // namespace spirit
+}  // namespace boost
+
+namespace Modelica {
+namespace Parser {
+template <typename Iterator>
+struct Skipper : qi::grammar<Iterator> {
+  Skipper() : Skipper::base_type(start) { start = layout; }
   qi::rule<Iterator> start;
 };
 template <typename T>
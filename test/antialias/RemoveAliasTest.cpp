@@ -0,0 +1,141 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/variant/get.hpp>
+
+#include <antialias/remove_alias.h>
+#include <mmo/mmo_class.h>
+#include <parser/parser.h>
+#include <util/debug.h>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+
+//____________________________________________________________________________//
+
+/// Parses file and removes its aliases. In aliases.mo a = b = c = x is a
+/// chain, d = -e and -e = f are negated, h is an alias of the constant g, and
+/// p = q; q = p is a cycle.
+MMO_Class *removeAliases(const std::string &file = "aliases.mo")
+{
+  bool r;
+  StoredDef sd = Parser::ParseFile(file, r);
+  if (!r) ERROR("Can't parse file\n");
+  MMO_Class *mmo = new MMO_Class(boost::get<Class>(sd.classes().front()));
+  RemoveAlias ra(*mmo);
+  ra.removeAliasEquations();
+  return mmo;
+}
+
+std::vector<std::string> equations(const MMO_Class &mmo)
+{
+  std::vector<std::string> eqs;
+  foreach_(const Equation &e, mmo.equations().equations())
+  {
+    std::stringstream s;
+    s << e;
+    eqs.push_back(s.str());
+  }
+  return eqs;
+}
+
+void TestRemainingVariables()
+{
+  MMO_Class *mmo = removeAliases();
+  std::vector<Name> vars = mmo->variables();
+  std::sort(vars.begin(), vars.end());
+  std::vector<Name> expected = {"f", "p", "x", "y"};
+  BOOST_CHECK(vars == expected);
+  std::vector<Name> eliminated = {"a", "b", "c", "d", "e", "g", "h", "q"};
+  foreach_(Name n, eliminated) BOOST_CHECK(!mmo->syms().lookup(n));
+  delete mmo;
+}
+
+void TestRemainingEquations()
+{
+  MMO_Class *mmo = removeAliases();
+  std::vector<std::string> eqs = equations(*mmo);
+  // The chain ends in x, d is -e = f, and h takes the value of g
+  std::vector<std::string> expected = {"der(x) = (-x)+y", "f = 2*x", "y = 3*f", "der(p) = y"};
+  BOOST_CHECK(eqs == expected);
+  delete mmo;
+}
+
+void TestCycleLeavesNoIdentity()
+{
+  MMO_Class *mmo = removeAliases();
+  foreach_(const Equation &e, mmo->equations().equations())
+  {
+    if (is<Equality>(e)) BOOST_CHECK(!(get<Equality>(e).left() == get<Equality>(e).right()));
+  }
+  delete mmo;
+}
+
+/// In array_aliases.mo a is y shifted by one, c is every second element of b,
+/// t is x negated and w only covers x[2:N]
+void TestArrayAliases()
+{
+  MMO_Class *mmo = removeAliases("array_aliases.mo");
+  std::vector<Name> kept = {"b", "w", "x", "y"};
+  foreach_(Name n, kept) BOOST_CHECK(mmo->syms().lookup(n));
+  std::vector<Name> eliminated = {"a", "c", "t"};
+  foreach_(Name n, eliminated) BOOST_CHECK(!mmo->syms().lookup(n));
+  std::vector<std::string> eqs = equations(*mmo);
+  BOOST_REQUIRE_EQUAL(eqs.size(), 5);
+  BOOST_CHECK_EQUAL(eqs[0], "for i in 1:N loop\n  der(x[i]) = y[i+1]+b[2*i]+(-x[i])+w[i];\nend for");
+  delete mmo;
+}
+
+/// w[1:N-1] = x[2:N] covers neither array, so both stay and so does the
+/// for-equation
+void TestPartialArrayAliasIsKept()
+{
+  MMO_Class *mmo = removeAliases("array_aliases.mo");
+  std::vector<std::string> eqs = equations(*mmo);
+  std::string partial = "for i in 1:N-1 loop\n  w[i] = x[i+1];\nend for";
+  BOOST_CHECK_EQUAL(std::count(eqs.begin(), eqs.end(), partial), 1);
+  delete mmo;
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "Alias removal";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestRemainingVariables));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestRemainingEquations));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestCycleLeavesNoIdentity));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestArrayAliases));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestPartialArrayAliasIsKept));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
@@ -0,0 +1,186 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/variant/get.hpp>
+
+#include <ast/serialize.h>
+#include <parser/parser.h>
+#include <util/debug.h>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+
+//____________________________________________________________________________//
+
+/// The models of test/flatter, in a fixed order
+std::vector<std::string> models()
+{
+  std::vector<std::string> files;
+  for (boost::filesystem::directory_entry &x : boost::filesystem::directory_iterator("../flatter"))
+    if (x.path().extension() == ".mo") files.push_back(x.path().generic_string());
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+StoredDef parse(const std::string &file)
+{
+  bool r;
+  StoredDef sd = Parser::ParseFile(file, r);
+  if (!r) ERROR("Can't parse %s\n", file.c_str());
+  return sd;
+}
+
+template <typename Node>
+std::string print(const Node &node)
+{
+  std::ostringstream out;
+  out << node;
+  return out.str();
+}
+
+std::string print(const ElemList &elements)
+{
+  std::ostringstream out;
+  foreach_(const Element &e, elements) out << e << "\n";
+  return out.str();
+}
+
+/// An image of a small model, used to damage in different ways
+std::string image()
+{
+  std::string img;
+  serialize(parse("../flatter/test4.mo"), img);
+  return img;
+}
+
+//____________________________________________________________________________//
+
+/// Every model reads back from its image and prints exactly as parsed
+void TestRoundTrip()
+{
+  std::vector<std::string> files = models();
+  BOOST_REQUIRE(!files.empty());
+  foreach_(const std::string &file, files)
+  {
+    StoredDef sd = parse(file);
+    std::string img;
+    serialize(sd, img);
+    StoredDef back;
+    BOOST_CHECK_MESSAGE(deserialize(img.data(), img.size(), back), file << " was not read back");
+    BOOST_CHECK_MESSAGE(print(back) == print(sd), file << " changed on the way through its image");
+  }
+}
+
+/// The element lists cached per class element read back as well
+void TestElementsRoundTrip()
+{
+  foreach_(const std::string &file, models())
+  {
+    StoredDef sd = parse(file);
+    foreach_(const ClassType &c, sd.classes())
+    {
+      if (!is<Class>(c)) continue;
+      const ElemList &elements = boost::get<Class>(c).composition().elements();
+      std::string img;
+      serialize(elements, img);
+      ElemList back;
+      BOOST_CHECK_MESSAGE(deserialize(img.data(), img.size(), back), file << " elements were not read back");
+      BOOST_CHECK_MESSAGE(print(back) == print(elements), file << " elements changed on the way through their image");
+    }
+  }
+}
+
+/// No proper prefix of an image is accepted, and a rejected read leaves the
+/// target as it was
+void TestTruncatedImagesAreRejected()
+{
+  std::string img = image();
+  StoredDef untouched = parse("../flatter/test1.mo");
+  std::string before = print(untouched);
+  for (size_t n = 0; n < img.size(); n++) {
+    StoredDef sd = untouched;
+    BOOST_CHECK_MESSAGE(!deserialize(img.data(), n, sd), "an image cut at " << n << " of " << img.size() << " bytes was accepted");
+    BOOST_CHECK(print(sd) == before);
+  }
+}
+
+void TestCorruptedImagesAreRejected()
+{
+  const std::string img = image();
+  StoredDef sd;
+
+  std::string magic = img;
+  magic[0] ^= 1;
+  BOOST_CHECK(!deserialize(magic.data(), magic.size(), sd));
+
+  std::string version = img;
+  version[4] = char(SERIAL_VERSION + 1);
+  BOOST_CHECK(!deserialize(version.data(), version.size(), sd));
+
+  std::string trailing = img + '\0';
+  BOOST_CHECK(!deserialize(trailing.data(), trailing.size(), sd));
+
+  std::string garbage(img.size(), '\xff');
+  garbage.replace(0, 8, img, 0, 8);
+  BOOST_CHECK(!deserialize(garbage.data(), garbage.size(), sd));
+}
+
+/// A damaged byte anywhere may go unnoticed, when it only changes a name or a
+/// number, but it never makes the reader run past the image or crash
+void TestDamagedBytesAreSafe()
+{
+  const std::string img = image();
+  for (size_t i = 0; i < img.size(); i++) {
+    std::string damaged = img;
+    damaged[i] = ~damaged[i];
+    StoredDef sd;
+    if (deserialize(damaged.data(), damaged.size(), sd)) print(sd);
+  }
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "AST images";
+
+  // Parse every model, not a cached image of it
+  unsetenv("MODELICACC_CACHE");
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestRoundTrip));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestElementsRoundTrip));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestTruncatedImagesAreRejected));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestCorruptedImagesAreRejected));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestDamagedBytesAreSafe));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
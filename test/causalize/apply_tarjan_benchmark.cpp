@@ -0,0 +1,64 @@
+#include <causalize/apply_tarjan.h>
+
+#include <util/debug.h>
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Causalize;
+
+/*
+ * Builds a causalization graph with n equations and n unknowns where
+ * equation i uses unknowns i and i-1, and every block of size loop
+ * closes an algebraic loop. This gives n/loop strong components.
+ */
+void build_graph(CausalizationGraph &graph, int n, int loop)
+{
+  std::vector<Vertex> eqs, unknowns;
+  for (int i = 0; i < n; i++) {
+    VertexProperty vpe;
+    vpe.type = E;
+    vpe.index = i;
+    vpe.visited = false;
+    eqs.push_back(add_vertex(vpe, graph));
+    VertexProperty vpu;
+    vpu.type = U;
+    vpu.index = i;
+    vpu.visited = false;
+    unknowns.push_back(add_vertex(vpu, graph));
+  }
+  for (int i = 0; i < n; i++) {
+    add_edge(eqs[i], unknowns[i], graph);
+    if (i % loop != 0) add_edge(eqs[i], unknowns[i - 1], graph);
+    if (i % loop == 0 && i + loop - 1 < n) add_edge(eqs[i], unknowns[i + loop - 1], graph);
+  }
+}
+
+void test(int n, int loop)
+{
+  struct timeval tval_before, tval_after, tval_result;
+  CausalizationGraph graph;
+  std::map<int, ComponentPtr> components;
+
+  build_graph(graph, n, loop);
+
+  gettimeofday(&tval_before, NULL);
+
+  int n_comps = apply_tarjan(graph, components);
+
+  gettimeofday(&tval_after, NULL);
+
+  timersub(&tval_after, &tval_before, &tval_result);
+
+  printf("N: %d\tComponents: %d\tTarjan: %ld.%06ld\n", n, n_comps, (long int)tval_result.tv_sec, (long int)tval_result.tv_usec);
+}
+
+int main(int argc, char const *argv[])
+{
+  int max_n = 64000;
+  if (argc > 1 && argv[1] != NULL) max_n = atoi(argv[1]);
+  for (int n = 1000; n <= max_n; n *= 2) test(n, 4);
+  return 0;
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/variant/get.hpp>
+
+#include <causalize/for_unrolling/process_for_equations.h>
+#include <causalize/for_unrolling/template_solver.h>
+#include <mmo/mmo_class.h>
+#include <parser/parser.h>
+#include <util/debug.h>
+#include <util/solve/solve.h>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+
+//____________________________________________________________________________//
+
+std::string print(const Equation &eq)
+{
+  std::stringstream s;
+  s << eq;
+  return s.str();
+}
+
+/// Every equation unrolled from a for loop must get the same causal form
+/// through the template of its body as when it is solved on its own.
+void template_matches_unrolled_test()
+{
+  bool r;
+  StoredDef sd = Parser::ParseFile("for_example_5.mo", r);
+  if (!r) ERROR("Can't parse file\n");
+
+  MMO_Class mmo(boost::get<Class>(sd.classes().front()));
+  Causalize::TemplateSolver solver(mmo.syms_ref());
+  Causalize::process_for_equations(mmo, &solver.templates());
+
+  const EquationList &eqs = mmo.equations().equations();
+  BOOST_CHECK(eqs.size() == 12);
+  BOOST_CHECK(solver.templates().instances.size() == eqs.size());
+  int instantiated = 0;
+  for (size_t i = 0; i < eqs.size(); i++) {
+    if (solver.templates().instances[i].body < 0) continue;
+    Expression unknown = boost::get<Equality>(eqs[i]).left();
+    Equation fromTemplate;
+    BOOST_CHECK(solver.Solve(i, unknown, fromTemplate));
+    EquationList direct;
+    BOOST_CHECK(EquationSolver::SolveLinear(EquationList(1, eqs[i]), ExpList(1, unknown), mmo.syms_ref(), direct));
+    BOOST_CHECK(direct.size() == 1);
+    BOOST_CHECK_EQUAL(print(fromTemplate), print(direct.front()));
+    instantiated++;
+  }
+  BOOST_CHECK(instantiated == 11);
+}
+
+/// Equations that do not come from a for loop are left to the caller
+void plain_equation_test()
+{
+  bool r;
+  StoredDef sd = Parser::ParseFile("for_example_5.mo", r);
+  if (!r) ERROR("Can't parse file\n");
+
+  MMO_Class mmo(boost::get<Class>(sd.classes().front()));
+  Causalize::TemplateSolver solver(mmo.syms_ref());
+  Causalize::process_for_equations(mmo, &solver.templates());
+
+  const EquationList &eqs = mmo.equations().equations();
+  Equation causal;
+  BOOST_CHECK(!solver.Solve(eqs.size() - 1, boost::get<Equality>(eqs.back()).left(), causal));
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "Template solver";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&template_matches_unrolled_test));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&plain_equation_test));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
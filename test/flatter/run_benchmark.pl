@@ -0,0 +1,43 @@
+#!/usr/bin/perl
+
+# Flattens every model of examples/testsuite and prints the best wall clock
+# time of each one and of the whole suite. Run it from this directory:
+#
+#   ./run_benchmark.pl [path/to/flatter]
+#
+# Models that flatter fails on are reported and left out of the total.
+
+use strict;
+use Time::HiRes qw(time);
+
+use constant REPETITION => 5;
+use constant SUITE => "../../examples/testsuite";
+
+my $flatter = shift || "../../bin/flatter";
+-x $flatter or die "cannot run $flatter";
+
+opendir(my $dh, SUITE) or die "cannot open " . SUITE . ": $!";
+my @models = sort grep { /\.mo$/ } readdir($dh);
+closedir($dh);
+
+my $total = 0;
+foreach my $model (@models) {
+	my $best;
+	my $failed = 0;
+	for (my $h = 0; $h < REPETITION && !$failed; $h++) {
+		my $start = time;
+		system("$flatter " . SUITE . "/$model > /dev/null 2>&1");
+		my $elapsed = time - $start;
+		$failed = $? != 0;
+		$best = $elapsed if !defined($best) || $elapsed < $best;
+	}
+
+	if ($failed) {
+		printf "%-32s failed\n", $model;
+		next;
+	}
+	printf "%-32s %.4f\n", $model, $best;
+	$total += $best;
+}
+
+printf "%-32s %.4f\n", "Total", $total;
@@ -0,0 +1,159 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <parser/class_split.h>
+#include <parser/parser.h>
+#include <util/debug.h>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+namespace fs = boost::filesystem;
+
+//____________________________________________________________________________//
+
+/// The models of test/flatter and examples/testsuite, in a fixed order
+std::vector<std::string> models()
+{
+  std::vector<std::string> files;
+  const char *dirs[] = {"../flatter", "../../examples/testsuite"};
+  foreach_(const char *dir, dirs)
+  {
+    for (fs::directory_entry &x : fs::directory_iterator(dir))
+      if (fs::is_regular_file(x.path()) && x.path().extension() == ".mo") files.push_back(x.path().generic_string());
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+std::string read(const std::string &file)
+{
+  std::ifstream in(file.c_str(), std::ios::binary);
+  std::ostringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+void write(const std::string &file, const std::string &text)
+{
+  std::ofstream out(file.c_str(), std::ios::binary);
+  out << text;
+}
+
+/// Parses file and prints the tree. With a cache directory the first class
+/// is split at its elements and every element is parsed on its own, or
+/// loaded if its text was seen before.
+std::string parsed(const std::string &file, const fs::path &cache)
+{
+  if (cache.empty())
+    unsetenv("MODELICACC_CACHE");
+  else
+    setenv("MODELICACC_CACHE", cache.c_str(), 1);
+  bool r;
+  StoredDef sd = Parser::ParseFile(file, r);
+  unsetenv("MODELICACC_CACHE");
+  BOOST_REQUIRE_MESSAGE(r, "can't parse " << file);
+  std::ostringstream out;
+  out << sd;
+  return out.str();
+}
+
+/// Number of element trees stored in the cache
+size_t cachedElements(const fs::path &cache)
+{
+  size_t n = 0;
+  for (fs::directory_entry &x : fs::directory_iterator(cache))
+    if (x.path().extension() == ".elem") n++;
+  return n;
+}
+
+/// A fresh cache directory, removed when it goes out of scope
+struct Cache {
+  Cache() : dir(fs::temp_directory_path() / fs::unique_path("modelicacc-split-%%%%-%%%%")) { fs::create_directories(dir); }
+  ~Cache() { fs::remove_all(dir); }
+  fs::path dir;
+};
+
+//____________________________________________________________________________//
+
+/// Splicing the separately parsed elements back into the first class gives
+/// the same tree as parsing the whole source
+void TestSplicedEqualsWhole()
+{
+  foreach_(const std::string &file, models())
+  {
+    Cache cache;
+    std::string whole = parsed(file, fs::path());
+    BOOST_CHECK_MESSAGE(parsed(file, cache.dir) == whole, file << " parses differently when split");
+  }
+}
+
+/// Each element of every model is replaced in turn. Only that element is
+/// parsed again, the others come from the cache, and the result still
+/// matches a full parse of the edited source.
+void TestEditOneElement()
+{
+  foreach_(const std::string &file, models())
+  {
+    std::string text = read(file);
+    Parser::ElementSplit split;
+    if (!Parser::splitElements(text.data(), text.data() + text.size(), split)) continue;
+    Cache cache;
+    parsed(file, cache.dir);
+    size_t cached = cachedElements(cache.dir);
+    BOOST_CHECK_MESSAGE(cached > 0 || split.elements.empty(), file << " was not parsed by elements");
+
+    fs::path edited = cache.dir / "edited.mo";
+    for (size_t k = 0; k < split.elements.size(); k++) {
+      size_t begin = split.elements[k].first - text.data(), end = split.elements[k].second - text.data();
+      std::string element = " Real edited_" + std::to_string(k) + ";";
+      write(edited.string(), text.substr(0, begin) + element + text.substr(end));
+      std::string spliced = parsed(edited.string(), cache.dir);
+      BOOST_CHECK_MESSAGE(spliced == parsed(edited.string(), fs::path()), file << " differs from a full parse with element " << k << " edited");
+      BOOST_CHECK_EQUAL(cachedElements(cache.dir), ++cached);
+    }
+  }
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "Split and splice parsing";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestSplicedEqualsWhole));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestEditOneElement));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
@@ -0,0 +1,160 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/variant/get.hpp>
+
+#include <parser/parser.h>
+#include <util/debug.h>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+
+//____________________________________________________________________________//
+
+Expression parse(const std::string &text)
+{
+  bool r;
+  Expression e = Parser::ParseExpression(text, r);
+  BOOST_REQUIRE_MESSAGE(r, "can't parse " << text);
+  return e;
+}
+
+std::string print(const Expression &e)
+{
+  std::ostringstream out;
+  out << e;
+  return out.str();
+}
+
+const Call &call(const Expression &e)
+{
+  BOOST_REQUIRE(is<Call>(e));
+  return boost::get<Call>(e);
+}
+
+//____________________________________________________________________________//
+
+void TestNestedCalls()
+{
+  Expression e = parse("f(g(x), h(y, k(1, 2)), 3)");
+  const Call &f = call(e);
+  BOOST_CHECK_EQUAL(f.name(), "f");
+  BOOST_REQUIRE_EQUAL(f.args().size(), 3);
+  BOOST_CHECK_EQUAL(call(f.args()[0]).args().size(), 1);
+  const Call &h = call(f.args()[1]);
+  BOOST_REQUIRE_EQUAL(h.args().size(), 2);
+  BOOST_CHECK_EQUAL(call(h.args()[1]).args().size(), 2);
+  BOOST_CHECK_EQUAL(print(e), "f(g(x),h(y,k(1,2)),3)");
+
+  // Each level used to try every shape of argument list again, which made
+  // this exponential in the depth
+  std::string deep = "x";
+  for (int i = 0; i < 30; i++) deep = "f(" + deep + ", 1)";
+  Expression d = parse(deep);
+  for (int i = 0; i < 30; i++) {
+    Expression inner = call(d).args().front();
+    d = inner;
+  }
+  BOOST_CHECK_EQUAL(print(d), "x");
+}
+
+void TestEmptyArguments()
+{
+  Expression e = parse("f()");
+  BOOST_CHECK(call(e).args().empty());
+  BOOST_CHECK(call(parse("f(g())")).args().size() == 1);
+}
+
+/// f(e for i in r) has one argument, a ForExp holding e and the indexes
+void TestForArgument()
+{
+  Expression e = parse("sum(x[i] * 2 for i in 1:n)");
+  const Call &c = call(e);
+  BOOST_CHECK_EQUAL(c.name(), "sum");
+  BOOST_REQUIRE_EQUAL(c.args().size(), 1);
+  BOOST_REQUIRE(is<ForExp>(c.args().front()));
+  const ForExp &f = boost::get<ForExp>(c.args().front());
+  BOOST_CHECK_EQUAL(print(f.exp()), "x[i]*2");
+  BOOST_REQUIRE_EQUAL(f.indices().indexes().size(), 1);
+  BOOST_CHECK_EQUAL(f.indices().indexes().front().name(), "i");
+
+  Expression e2 = parse("f(a[i, j] for i in 1:n, j in 1:m)");
+  const ForExp &two = boost::get<ForExp>(call(e2).args().front());
+  BOOST_CHECK_EQUAL(two.indices().indexes().size(), 2);
+}
+
+void TestNamedArguments()
+{
+  Expression e = parse("f(a = 1, b = x + y)");
+  const Call &c = call(e);
+  BOOST_REQUIRE_EQUAL(c.args().size(), 2);
+  BOOST_REQUIRE(is<Named>(c.args()[0]));
+  BOOST_REQUIRE(is<Named>(c.args()[1]));
+  BOOST_CHECK_EQUAL(boost::get<Named>(c.args()[0]).name(), "a");
+  BOOST_CHECK_EQUAL(boost::get<Named>(c.args()[1]).name(), "b");
+  BOOST_CHECK_EQUAL(print(boost::get<Named>(c.args()[1]).exp()), "x+y");
+}
+
+/// Positional arguments come first and keep their order, then the named ones
+void TestMixedArguments()
+{
+  Expression e = parse("f(1, g(x), y, a = 2, b = h(z))");
+  const Call &c = call(e);
+  BOOST_REQUIRE_EQUAL(c.args().size(), 5);
+  BOOST_CHECK(is<Integer>(c.args()[0]));
+  BOOST_CHECK(is<Call>(c.args()[1]));
+  BOOST_CHECK(is<Reference>(c.args()[2]));
+  BOOST_REQUIRE(is<Named>(c.args()[3]));
+  BOOST_REQUIRE(is<Named>(c.args()[4]));
+  BOOST_CHECK_EQUAL(boost::get<Named>(c.args()[3]).name(), "a");
+  BOOST_CHECK(is<Call>(boost::get<Named>(c.args()[4]).exp()));
+}
+
+void TestMalformedArguments()
+{
+  bool r;
+  Parser::ParseExpression("f(a = 1, 2)", r);
+  BOOST_CHECK(!r);
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "Function arguments";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestNestedCalls));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestEmptyArguments));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestForArgument));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestNamedArguments));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestMixedArguments));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestMalformedArguments));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
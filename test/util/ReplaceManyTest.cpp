@@ -0,0 +1,147 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <parser/parser.h>
+#include <util/ast_visitors/replace_many.h>
+#include <util/debug.h>
+#include <sstream>
+
+using namespace boost::unit_test;
+using namespace Modelica;
+using namespace Modelica::AST;
+
+//____________________________________________________________________________//
+
+Expression parse(const std::string &text)
+{
+  bool r;
+  Expression e = Parser::ParseExpression(text, r);
+  if (!r) ERROR("Can't parse %s\n", text.c_str());
+  return e;
+}
+
+/// Renames with arrays and checks the result against the parsed expected text
+void checkRename(const ReplaceArrayMap &arrays, const std::string &text, const std::string &expected)
+{
+  ReplaceMap none;
+  Expression got = Apply(ReplaceMany(none, arrays), parse(text));
+  BOOST_CHECK_MESSAGE(got == parse(expected), text << " became " << got << ", expected " << expected);
+}
+
+/// a[k] is b[2 * k - 1], a covers the odd elements of b
+void TestGainAndNegativeOffset()
+{
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 2, -1, 5, false);
+  checkRename(arrays, "a[3]", "b[5]");
+  checkRename(arrays, "a[1]", "b[1]");
+  checkRename(arrays, "a[i]", "b[2 * i - 1]");
+  checkRename(arrays, "x + a[j]", "x + b[2 * j - 1]");
+}
+
+/// a[k] is b[k - 2] with the sign flipped
+void TestNegatedShift()
+{
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 1, -2, 4, true);
+  checkRename(arrays, "a[3]", "-b[1]");
+  checkRename(arrays, "a[i]", "-b[i - 2]");
+  checkRename(arrays, "a[2:4]", "-b[0:2]");
+}
+
+void TestWholeArray()
+{
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 1, 3, 4, false);
+  arrays["c"] = ArrayRename("d", 2, -1, 5, false);
+  arrays["e"] = ArrayRename("f", 1, 0, 6, false);
+  // A bare reference and a[:] both become the covered slice
+  checkRename(arrays, "a", "b[4:7]");
+  checkRename(arrays, "a[:]", "b[4:7]");
+  checkRename(arrays, "c", "d[1:2:9]");
+  checkRename(arrays, "c[:]", "d[1:2:9]");
+  // The identity only renames
+  checkRename(arrays, "e", "f");
+  checkRename(arrays, "e[i]", "f[i]");
+}
+
+void TestSteppedRange()
+{
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 1, 3, 10, false);
+  arrays["c"] = ArrayRename("d", 2, -1, 10, false);
+  checkRename(arrays, "a[1:2:5]", "b[4:2:8]");
+  checkRename(arrays, "c[1:2:5]", "d[1:2 * 2:9]");
+  checkRename(arrays, "c[2:4]", "d[3:2 * 1:7]");
+}
+
+std::string print(const Expression &e)
+{
+  std::ostringstream out;
+  out << e;
+  return out.str();
+}
+
+/// BinOp prints without parentheses, so a scaled subscript that is not atomic
+/// must be grouped, or the printed model means something else
+void TestScaledSubscriptPrints()
+{
+  ReplaceMap none;
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 2, -1, 10, false);
+  arrays["c"] = ArrayRename("d", 2, 0, 10, true);
+  BOOST_CHECK_EQUAL(print(Apply(ReplaceMany(none, arrays), parse("a[N - i + 1]"))), "b[2*(N-i+1)-1]");
+  BOOST_CHECK_EQUAL(print(Apply(ReplaceMany(none, arrays), parse("c[N - i + 1]"))), "(-d[2*(N-i+1)])");
+  BOOST_CHECK_EQUAL(print(Apply(ReplaceMany(none, arrays), parse("a[i]"))), "b[2*i-1]");
+  BOOST_CHECK_EQUAL(print(Apply(ReplaceMany(none, arrays), parse("a[1:k + 1:5]"))), "b[1:2*(k+1):9]");
+}
+
+/// Scalar substitution still applies inside the shifted subscripts
+void TestWithScalars()
+{
+  ReplaceMap scalars;
+  scalars["i"] = Integer(2);
+  ReplaceArrayMap arrays;
+  arrays["a"] = ArrayRename("b", 2, -1, 5, false);
+  Expression got = Apply(ReplaceMany(scalars, arrays), parse("a[i] + i"));
+  BOOST_CHECK(got == parse("b[3] + 2"));
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "ReplaceMany array renames";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestGainAndNegativeOffset));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestNegatedShift));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestWholeArray));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestSteppedRange));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestScaledSubscriptPrints));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestWithScalars));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
@@ -0,0 +1,143 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <util/debug.h>
+#include <util/thread_pool.h>
+
+using namespace boost::unit_test;
+
+//____________________________________________________________________________//
+
+void TestEveryIndexOnce()
+{
+  for (int jobs = 1; jobs <= 4; jobs++) {
+    std::vector<int> runs(1000);
+    parallelFor(runs.size(), jobs, [&](size_t i) { runs[i]++; });
+    BOOST_CHECK(std::count(runs.begin(), runs.end(), 1) == 1000);
+  }
+}
+
+void TestCallerIsNotWorker()
+{
+  std::atomic<int> workers(0);
+  parallelFor(100, 4, [&](size_t) {
+    if (onWorkerThread()) workers++;
+  });
+  BOOST_CHECK(workers == 100);
+  BOOST_CHECK(!onWorkerThread());
+}
+
+void TestExceptionReachesCaller()
+{
+  std::atomic<int> after(0);
+  std::string what;
+  try {
+    parallelFor(1000, 4, [&](size_t i) {
+      if (i >= 10) throw std::runtime_error(std::to_string(i));
+      if (i > 500) after++;
+    });
+  } catch (const std::runtime_error &e) {
+    what = e.what();
+  }
+  // Items are handed out in order, so the lowest failing index always runs
+  BOOST_CHECK(what == "10");
+  BOOST_CHECK(after == 0);
+}
+
+void TestSequentialException()
+{
+  bool caught = false;
+  try {
+    parallelFor(10, 1, [&](size_t i) {
+      if (i == 3) throw std::logic_error("3");
+    });
+  } catch (const std::logic_error &) {
+    caught = true;
+  }
+  BOOST_CHECK(caught);
+}
+
+/// @brief Runs body in a child process and returns its exit status, -1 if it
+/// did not exit normally
+int exitStatus(void (*body)())
+{
+  std::cout.flush();
+  fflush(NULL);
+  pid_t pid = fork();
+  if (pid == 0) {
+    body();
+    _exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+void failInJobs()
+{
+  if (!freopen("/dev/null", "w", stderr)) return;
+  parallelFor(100, 4, [](size_t i) {
+    if (i == 42) ERROR("job %d failed", (int)i);
+  });
+}
+
+void exitInJobs()
+{
+  parallelFor(100, 4, [](size_t i) {
+    if (i == 7) fatalExit(3);
+  });
+}
+
+void TestFatalErrorExitsFromCaller()
+{
+  BOOST_CHECK(exitStatus(&failInJobs) == EXIT_FAILURE);
+  BOOST_CHECK(exitStatus(&exitInJobs) == 3);
+}
+
+//____________________________________________________________________________//
+
+test_suite *init_unit_test_suite(int, char *[])
+{
+  framework::master_test_suite().p_name.value = "Thread pool";
+
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestEveryIndexOnce));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestCallerIsNotWorker));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestExceptionReachesCaller));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestSequentialException));
+  framework::master_test_suite().add(BOOST_TEST_CASE(&TestFatalErrorExitsFromCaller));
+
+  return 0;
+}
+
+//____________________________________________________________________________//
+
+// EOF
@@ -26,31 +26,31 @@ bool ConstantExpression::operator()(Integer v) const { return true; }
 
 bool ConstantExpression::operator()(Boolean v) const { return true; }
 
-bool ConstantExpression::operator()(AddAll v) const {return false;}
+bool ConstantExpression::operator()(const AddAll &v) const {return false;}
 
-bool ConstantExpression::operator()(String v) const { return true; }
+bool ConstantExpression::operator()(const String &v) const { return true; }
 
-bool ConstantExpression::operator()(Name v) const { return true; }
+bool ConstantExpression::operator()(const Name &v) const { return true; }
 
 bool ConstantExpression::operator()(Real v) const { return true; }
 
-bool ConstantExpression::operator()(SubEnd v) const { return false; }
+bool ConstantExpression::operator()(const SubEnd &v) const { return false; }
 
-bool ConstantExpression::operator()(SubAll v) const { return false; }
+bool ConstantExpression::operator()(const SubAll &v) const { return false; }
 
-bool ConstantExpression::operator()(BinOp v) const
+bool ConstantExpression::operator()(const BinOp &v) const
 {
   Expression l = v.left(), r = v.right();
   return ApplyThis(l) && ApplyThis(r);
 }
 
-bool ConstantExpression::operator()(UnaryOp v) const
+bool ConstantExpression::operator()(const UnaryOp &v) const
 {
   Expression e = v.exp();
   return ApplyThis(e);
 }
 
-bool ConstantExpression::operator()(IfExp v) const
+bool ConstantExpression::operator()(const IfExp &v) const
 {
   Expression cond = v.cond();
   Expression then = v.then();
@@ -60,7 +60,7 @@ bool ConstantExpression::operator()(IfExp v) const
   return ApplyThis(cond) && ApplyThis(then) && list && ApplyThis(elseexp);
 }
 
-bool ConstantExpression::operator()(Range v) const
+bool ConstantExpression::operator()(const Range &v) const
 {
   Expression start = v.start(), end = v.end();
   if (v.step()) {
@@ -70,35 +70,35 @@ bool ConstantExpression::operator()(Range v) const
     return ApplyThis(start) && ApplyThis(end);
 }
 
-bool ConstantExpression::operator()(Brace v) const
+bool ConstantExpression::operator()(const Brace &v) const
 {
   bool list = true;
   foreach_(Expression e, v.args()) list = list && ApplyThis(e);
   return list;
 }
 
-bool ConstantExpression::operator()(Bracket v) const
+bool ConstantExpression::operator()(const Bracket &v) const
 {
   bool list = true;
   foreach_(ExpList els, v.args()) foreach_(Expression e, els) list &= ApplyThis(e);
   return list;
 }
 
-bool ConstantExpression::operator()(Call v) const
+bool ConstantExpression::operator()(const Call &v) const
 {
   bool list = true;
   foreach_(Expression e, v.args()) list &= ApplyThis(e);
   return list;
 }
 
-bool ConstantExpression::operator()(FunctionExp v) const
+bool ConstantExpression::operator()(const FunctionExp &v) const
 {
   bool list = false;
   foreach_(Expression e, v.args()) list &= ApplyThis(e);
   return list;
 }
 
-bool ConstantExpression::operator()(ForExp v) const
+bool ConstantExpression::operator()(const ForExp &v) const
 {
   Expression exp = v.exp();
   bool indices = true;
@@ -109,18 +109,18 @@ bool ConstantExpression::operator()(ForExp v) const
   return indices;
 }
 
-bool ConstantExpression::operator()(Named v) const
+bool ConstantExpression::operator()(const Named &v) const
 {
   Expression exp = v.exp();
   return ApplyThis(exp);
 }
 
-bool ConstantExpression::operator()(Output v) const
+bool ConstantExpression::operator()(const Output &v) const
 {
   bool list = true;
   foreach_(OptExp e, v.args()) if (e) list &= ApplyThis(e.get());
   return list;
 }
 
-bool ConstantExpression::operator()(Reference v) const { return false; }
+bool ConstantExpression::operator()(const Reference &v) const { return false; }
 }  // namespace Modelica
@@ -25,8 +25,8 @@ namespace Modelica {
 ContainsExpression::ContainsExpression(Expression e) : exp(e){};
 bool ContainsExpression::operator()(Integer v) const { return exp == Expression(v); }
 bool ContainsExpression::operator()(Boolean v) const { return exp == Expression(v); }
-bool ContainsExpression::operator()(String v) const { return exp == Expression(v); }
-bool ContainsExpression::operator()(AddAll v) const{
+bool ContainsExpression::operator()(const String &v) const { return exp == Expression(v); }
+bool ContainsExpression::operator()(const AddAll &v) const{
   if(exp == Expression(v)) return true;
 
   RefTuple rt = v.arr();
@@ -42,11 +42,11 @@ bool ContainsExpression::operator()(AddAll v) const{
 
   return false;
 }
-bool ContainsExpression::operator()(Name v) const { return exp == Expression(v); }
+bool ContainsExpression::operator()(const Name &v) const { return exp == Expression(v); }
 bool ContainsExpression::operator()(Real v) const { return exp == Expression(v); }
-bool ContainsExpression::operator()(SubEnd v) const { return exp == Expression(v); }
-bool ContainsExpression::operator()(SubAll v) const { return exp == Expression(v); }
-bool ContainsExpression::operator()(BinOp v) const
+bool ContainsExpression::operator()(const SubEnd &v) const { return exp == Expression(v); }
+bool ContainsExpression::operator()(const SubAll &v) const { return exp == Expression(v); }
+bool ContainsExpression::operator()(const BinOp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression l = v.left(), r = v.right();
@@ -54,13 +54,13 @@ bool ContainsExpression::operator()(BinOp v) const
   bool ll = ApplyThis(r);
   return rl || ll;
 }
-bool ContainsExpression::operator()(UnaryOp v) const
+bool ContainsExpression::operator()(const UnaryOp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression e = v.exp();
   return ApplyThis(e);
 }
-bool ContainsExpression::operator()(IfExp v) const
+bool ContainsExpression::operator()(const IfExp &v) const
 {
   if (exp == Expression(v)) return true;
   Expression cond = v.cond(), then = v.then(), elseexp = v.elseexp();
@@ -69,7 +69,7 @@ bool ContainsExpression::operator()(IfExp v) const
   const bool re = ApplyThis(elseexp);
   return rc || rt || re;
 }
-bool ContainsExpression::operator()(Range v) const
+bool ContainsExpression::operator()(const Range &v) const
 {
   if (exp == Expression(v)) return true;
   Expression start = v.start(), end = v.end();
@@ -77,52 +77,52 @@ bool ContainsExpression::operator()(Range v) const
   bool re = ApplyThis(end);
   return rs || re;
 }
-bool ContainsExpression::operator()(Brace v) const
+bool ContainsExpression::operator()(const Brace &v) const
 {
   if (exp == Expression(v)) return true;
   ERROR("ContainsExpression: Brace expression not supported");
   // TODO
   return false;
 }
-bool ContainsExpression::operator()(Bracket v) const
+bool ContainsExpression::operator()(const Bracket &v) const
 {
   if (exp == Expression(v)) return true;
   ERROR("ContainsExpression: Bracket expression not supported");
   // TODO
   return false;
 }
-bool ContainsExpression::operator()(Call v) const
+bool ContainsExpression::operator()(const Call &v) const
 {
   if (exp == Expression(v)) return true;
   foreach_(Expression e, v.args()) if (ApplyThis(e)) return true;
   return false;
 }
-bool ContainsExpression::operator()(FunctionExp v) const
+bool ContainsExpression::operator()(const FunctionExp &v) const
 {
   if (exp == Expression(v)) return true;
   // TODO
   return false;
 }
-bool ContainsExpression::operator()(ForExp v) const
+bool ContainsExpression::operator()(const ForExp &v) const
 {
   if (exp == Expression(v)) return true;
   ERROR("ContainsExpression: For expression not supported");
   // TODO
   return false;
 }
-bool ContainsExpression::operator()(Named v) const
+bool ContainsExpression::operator()(const Named &v) const
 {
   if (exp == Expression(v)) return true;
   // TODO
   return false;
 }
-bool ContainsExpression::operator()(Output v) const
+bool ContainsExpression::operator()(const Output &v) const
 {
   if (exp == Expression(v)) return true;
   foreach_(OptExp oe, v.args()) if (oe && ApplyThis(oe.get())) return true;
   return false;
 }
-bool ContainsExpression::operator()(Reference v) const
+bool ContainsExpression::operator()(const Reference &v) const
 {
   if (exp == Expression(v)) return true;
   if (is<Reference>(exp)) {
@@ -29,7 +29,7 @@ DotExpression::DotExpression(Option<MMO_Class &> m, Name n, ExpList xs) : _class
 };
 Expression DotExpression::operator()(Integer v) const { return v; }
 Expression DotExpression::operator()(Boolean v) const { return v; }
-Expression DotExpression::operator()(AddAll v) const{
+Expression DotExpression::operator()(const AddAll &v) const{
   RefTuple rt = v.arr(); 
   Name name;
   ExpList indices;
@@ -45,23 +45,23 @@ Expression DotExpression::operator()(AddAll v) const{
   AddAll res(rtres);
   return res;
 }
-Expression DotExpression::operator()(String v) const { return v; }
-Expression DotExpression::operator()(Name v) const { return v; }
+Expression DotExpression::operator()(const String &v) const { return v; }
+Expression DotExpression::operator()(const Name &v) const { return v; }
 Expression DotExpression::operator()(Real v) const { return v; }
-Expression DotExpression::operator()(SubEnd v) const { return v; }
-Expression DotExpression::operator()(SubAll v) const { return v; }
-Expression DotExpression::operator()(BinOp v) const
+Expression DotExpression::operator()(const SubEnd &v) const { return v; }
+Expression DotExpression::operator()(const SubAll &v) const { return v; }
+Expression DotExpression::operator()(const BinOp &v) const
 {
   Expression l = v.left(), r = v.right();
   return BinOp(ApplyThis(l), v.op(), ApplyThis(r));
 }
-Expression DotExpression::operator()(UnaryOp v) const
+Expression DotExpression::operator()(const UnaryOp &v) const
 {
   Expression e = v.exp();
   return UnaryOp(ApplyThis(e), v.op());
 }
 
-Expression DotExpression::operator()(IfExp v) const
+Expression DotExpression::operator()(const IfExp &v) const
 {
   Expression cond = v.cond();
   Expression then = v.then();
@@ -71,7 +71,7 @@ Expression DotExpression::operator()(IfExp v) const
   return IfExp(ApplyThis(cond), ApplyThis(then), list, ApplyThis(elseexp));
 }
 
-Expression DotExpression::operator()(Range v) const
+Expression DotExpression::operator()(const Range &v) const
 {
   Expression start = v.start(), end = v.end();
   if (v.step()) {
@@ -81,13 +81,13 @@ Expression DotExpression::operator()(Range v) const
     return Range(ApplyThis(start), ApplyThis(end));
   return v;
 }
-Expression DotExpression::operator()(Brace v) const
+Expression DotExpression::operator()(const Brace &v) const
 {
   ExpList list;
   foreach_(Expression e, v.args()) list.push_back(ApplyThis(e));
   return Brace(list);
 }
-Expression DotExpression::operator()(Bracket v) const
+Expression DotExpression::operator()(const Bracket &v) const
 {
   ExpListList list;
   foreach_(ExpList els, v.args())
@@ -98,20 +98,20 @@ Expression DotExpression::operator()(Bracket v) const
   }
   return Bracket(list);
 }
-Expression DotExpression::operator()(Call v) const
+Expression DotExpression::operator()(const Call &v) const
 {
   ExpList list;
   foreach_(Expression e, v.args()) list.push_back(ApplyThis(e));
   return Call(v.name(), list);
 }
-Expression DotExpression::operator()(FunctionExp v) const
+Expression DotExpression::operator()(const FunctionExp &v) const
 {
   ExpList list;
   foreach_(Expression e, v.args()) list.push_back(ApplyThis(e));
   return FunctionExp(v.name(), list);
 }
 
-Expression DotExpression::operator()(ForExp v) const
+Expression DotExpression::operator()(const ForExp &v) const
 {
   Expression exp = v.exp();
   IndexList indices;
@@ -125,20 +125,20 @@ Expression DotExpression::operator()(ForExp v) const
   return ForExp(ApplyThis(exp), Indexes(indices));
 }
 
-Expression DotExpression::operator()(Named v) const
+Expression DotExpression::operator()(const Named &v) const
 {
   Expression exp = v.exp();
   return Named(v.name(), ApplyThis(exp));
 }
 
-Expression DotExpression::operator()(Output v) const
+Expression DotExpression::operator()(const Output &v) const
 {
   OptExpList list;
   foreach_(OptExp e, v.args()) if (e) list.push_back(ApplyThis(e.get()));
   else list.push_back(OptExp());
   return Output(list);
 }
-Expression DotExpression::operator()(Reference v) const
+Expression DotExpression::operator()(const Reference &v) const
 {
   int i = 0, j = v.ref().size();
   Ref ref;
@@ -172,7 +172,7 @@ Expression DotExpression::operator()(Reference v) const
 
 Option<Expression> DotExpression::findConst(Reference v) const
 {
-  ClassFinder cf = ClassFinder();
+  ClassFinder cf;
   MMO_Class c = _class.get();
   int i = 0;
   foreach_(RefTuple p, v.ref())
@@ -187,9 +187,9 @@ Option<Expression> DotExpression::findConst(Reference v) const
       }
       c = *boost::get<Type::Class>(get<1>(td)).clase();
     } else if (i != 0) {
-      Option<VarInfo> Opvv = c.syms_ref()[n];
+      const VarInfo *Opvv = c.syms_ref().lookup(n);
       if (Opvv) {
-        VarInfo vv = Opvv.get();
+        const VarInfo &vv = *Opvv;
         if (vv.modification() && is<ModEq>(vv.modification().get())) {
           Expression exp = get<ModEq>(vv.modification().get()).exp();
           DotExpression visitor = DotExpression(Option<MMO_Class &>(c), "", ExpList());
@@ -34,24 +34,24 @@ class DotExpression : public boost::static_visitor<Expression> {
   DotExpression(Option<MMO_Class &> c, Name n, ExpList xs);
   Expression operator()(Integer v) const;
   Expression operator()(Boolean v) const;
-  Expression operator()(AddAll v) const;
-  Expression operator()(String v) const;
-  Expression operator()(Name v) const;
+  Expression operator()(const AddAll &v) const;
+  Expression operator()(const String &v) const;
+  Expression operator()(const Name &v) const;
   Expression operator()(Real v) const;
-  Expression operator()(SubEnd v) const;
-  Expression operator()(SubAll v) const;
-  Expression operator()(BinOp) const;
-  Expression operator()(UnaryOp) const;
-  Expression operator()(Brace) const;
-  Expression operator()(Bracket) const;
-  Expression operator()(Call) const;
-  Expression operator()(FunctionExp) const;
-  Expression operator()(ForExp) const;
-  Expression operator()(IfExp) const;
-  Expression operator()(Named) const;
-  Expression operator()(Output) const;
-  Expression operator()(Reference) const;
-  Expression operator()(Range) const;
+  Expression operator()(const SubEnd &v) const;
+  Expression operator()(const SubAll &v) const;
+  Expression operator()(const BinOp &) const;
+  Expression operator()(const UnaryOp &) const;
+  Expression operator()(const Brace &) const;
+  Expression operator()(const Bracket &) const;
+  Expression operator()(const Call &) const;
+  Expression operator()(const FunctionExp &) const;
+  Expression operator()(const ForExp &) const;
+  Expression operator()(const IfExp &) const;
+  Expression operator()(const Named &) const;
+  Expression operator()(const Output &) const;
+  Expression operator()(const Reference &) const;
+  Expression operator()(const Range &) const;
   OptExp findConst(Reference v) const;
   Option<VarSymbolTable &> syms;
   Option<MMO_Class &> _class;
@@ -45,34 +45,34 @@ Real EvalExpression::operator()(Boolean v) const{
   return 0.0;
 }
 
-Real EvalExpression::operator()(AddAll v) const{
+Real EvalExpression::operator()(const AddAll &v) const{
   ERROR("EvalExpression: trying to evaluate a AddAll");
   return 0;
 }
 
-Real EvalExpression::operator()(String v) const{
+Real EvalExpression::operator()(const String &v) const{
   ERROR("EvalExpression: trying to evaluate a String");
   return 0;
 }
 
-Real EvalExpression::operator()(Name v) const{
+Real EvalExpression::operator()(const Name &v) const{
   ERROR("EvalExpression: trying to evaluate a Name");
   return 0;
 }
 
 Real EvalExpression::operator()(Real v) const {return v;}
 
-Real EvalExpression::operator()(SubAll v) const{
+Real EvalExpression::operator()(const SubAll &v) const{
   ERROR("EvalExpression: trying to evaluate a SubAll");
   return 0;
 }
 
-Real EvalExpression::operator()(SubEnd v) const{
+Real EvalExpression::operator()(const SubEnd &v) const{
   ERROR("EvalExpression: trying to evaluate a SubEnd");
   return 0;
 }
 
-Real EvalExpression::operator()(BinOp v) const{
+Real EvalExpression::operator()(const BinOp &v) const{
   Expression l = v.left(), r = v.right();
   switch (v.op()){
     case Add:
@@ -91,7 +91,7 @@ Real EvalExpression::operator()(BinOp v) const{
   }
 }
 
-Real EvalExpression::operator()(UnaryOp v) const{
+Real EvalExpression::operator()(const UnaryOp &v) const{
   if (v.op() == Minus){
     Expression e = v.exp();
     return -ApplyThis(e);
@@ -106,27 +106,27 @@ Real EvalExpression::operator()(UnaryOp v) const{
   return 0;
 }
 
-Real EvalExpression::operator()(IfExp v) const{
+Real EvalExpression::operator()(const IfExp &v) const{
   ERROR("EvalExpression: trying to evaluate a IfExp");
   return 0;
 }
 
-Real EvalExpression::operator()(Range v) const{
+Real EvalExpression::operator()(const Range &v) const{
   ERROR("EvalExpression: trying to evaluate a Range");
   return 0;
 }
 
-Real EvalExpression::operator()(Brace v) const{
+Real EvalExpression::operator()(const Brace &v) const{
   WARNING("EvalExpression: trying to evaluate a Brace");
   return 0;
 }
 
-Real EvalExpression::operator()(Bracket v) const{
+Real EvalExpression::operator()(const Bracket &v) const{
   ERROR("EvalExpression: trying to evaluate a Bracket");
   return 0;
 }
 
-Real EvalExpression::operator()(Call v) const{
+Real EvalExpression::operator()(const Call &v) const{
   if ("integer" == v.name())
     return ApplyThis(v.args().front());
 
@@ -137,22 +137,22 @@ Real EvalExpression::operator()(Call v) const{
   return 0;
 }
 
-Real EvalExpression::operator()(FunctionExp v) const{
+Real EvalExpression::operator()(const FunctionExp &v) const{
   ERROR("EvalExpression: trying to evaluate a FunctionExp");
   return 0;
 }
 
-Real EvalExpression::operator()(ForExp v) const{
+Real EvalExpression::operator()(const ForExp &v) const{
   ERROR("EvalExpression: trying to evaluate a ForExp");
   return 0;
 }
 
-Real EvalExpression::operator()(Named v) const{
+Real EvalExpression::operator()(const Named &v) const{
   ERROR("EvalExpression: trying to evaluate a Named");
   return 0;
 }
 
-Real EvalExpression::operator()(Output v) const{
+Real EvalExpression::operator()(const Output &v) const{
   ERROR_UNLESS(v.args().size() == 1, "EvalExpression: Output expression with more than one element are not supported");
   if (v.args().front()){
     Expression e = v.args().front().get();
@@ -163,7 +163,7 @@ Real EvalExpression::operator()(Output v) const{
   return 0;
 }
 
-Real EvalExpression::operator()(Reference v) const{
+Real EvalExpression::operator()(const Reference &v) const{
   Ref r = v.ref();
   ERROR_UNLESS(r.size() == 1, "EvalExpression: conversion of dotted references not implemented");
   Option<ExpList> oel = boost::get<1>(r[0]);
@@ -172,13 +172,13 @@ Real EvalExpression::operator()(Reference v) const{
 
   if (name && name.get() == s) return val.get();
 
-  Option<VarInfo> vinfo = vtable[s];
+  const VarInfo *vinfo = vtable.lookup(s);
   if (!vinfo) ERROR("EvalExpression: Variable %s not found!", s.c_str());
-  if (!vinfo.get().modification()) {
+  if (!vinfo->modification()) {
     ERROR("EvalExpression: Variable %s without initial value!", s.c_str());
   }
 
-  Modification m = vinfo.get().modification().get();
+  Modification m = vinfo->modification().get();
 
   if (is<ModEq>(m)){
     Expression meq = boost::get<ModEq>(m).exp();
@@ -242,19 +242,19 @@ Interval EvalExpFlatter::operator()(Boolean v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(AddAll v) const{
+Interval EvalExpFlatter::operator()(const AddAll &v) const{
   ERROR("EvalExpFlatter: trying to evaluate an AddAll");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(String v) const{
+Interval EvalExpFlatter::operator()(const String &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a String");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Name v) const{
+Interval EvalExpFlatter::operator()(const Name &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a Name");
   Interval i;
   return i;
@@ -266,7 +266,7 @@ Interval EvalExpFlatter::operator()(Real v) const {
   return i;
 }
 
-Interval EvalExpFlatter::operator()(SubAll v) const{
+Interval EvalExpFlatter::operator()(const SubAll &v) const{
 /*
   Option<VarInfo> ovi = vtable[v];
   if(ovi){
@@ -291,13 +291,13 @@ Interval EvalExpFlatter::operator()(SubAll v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(SubEnd v) const{
+Interval EvalExpFlatter::operator()(const SubEnd &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a SubEnd");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(BinOp v) const{
+Interval EvalExpFlatter::operator()(const BinOp &v) const{
   Expression l = v.left(), r = v.right();
   Interval ll = ApplyThis(l), rr = ApplyThis(r); 
 
@@ -383,7 +383,7 @@ Interval EvalExpFlatter::operator()(BinOp v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(UnaryOp v) const{
+Interval EvalExpFlatter::operator()(const UnaryOp &v) const{
   EvalExpression evexp(vtable);
   Expression e(v);
   Real aux = Apply(evexp, e);
@@ -393,13 +393,13 @@ Interval EvalExpFlatter::operator()(UnaryOp v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(IfExp v) const{
+Interval EvalExpFlatter::operator()(const IfExp &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a IfExp");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Range v) const{
+Interval EvalExpFlatter::operator()(const Range &v) const{
   EvalExpression evexp(vtable);
   Expression st = v.start();
   Real auxLo = Apply(evexp, st);
@@ -420,19 +420,19 @@ Interval EvalExpFlatter::operator()(Range v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Brace v) const{
+Interval EvalExpFlatter::operator()(const Brace &v) const{
   WARNING("EvalExpFlatter: trying to evaluate a Brace");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Bracket v) const{
+Interval EvalExpFlatter::operator()(const Bracket &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a Bracket");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Call v) const{
+Interval EvalExpFlatter::operator()(const Call &v) const{
   if ("integer" == v.name()){
     EvalExpression evexp(vtable);
     Real aux = Apply(evexp, v.args().front());
@@ -453,25 +453,25 @@ Interval EvalExpFlatter::operator()(Call v) const{
   return 0;
 }
 
-Interval EvalExpFlatter::operator()(FunctionExp v) const{
+Interval EvalExpFlatter::operator()(const FunctionExp &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a FunctionExp");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(ForExp v) const{
+Interval EvalExpFlatter::operator()(const ForExp &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a ForExp");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Named v) const{
+Interval EvalExpFlatter::operator()(const Named &v) const{
   ERROR("EvalExpFlatter: trying to evaluate a Named");
   Interval i;
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Output v) const{
+Interval EvalExpFlatter::operator()(const Output &v) const{
   ERROR_UNLESS(v.args().size() == 1, "EvalExpFlatter: Output expression with more than one element are not supported");
   if (v.args().front()){
     Expression e = v.args().front().get();
@@ -487,7 +487,7 @@ Interval EvalExpFlatter::operator()(Output v) const{
   return i;
 }
 
-Interval EvalExpFlatter::operator()(Reference v) const{
+Interval EvalExpFlatter::operator()(const Reference &v) const{
   Ref r = v.ref();
   ERROR_UNLESS(r.size() == 1, "EvalExpFlatter: conversion of dotted references not implemented");
   Option<ExpList> oel = boost::get<1>(r[0]);
@@ -501,13 +501,13 @@ Interval EvalExpFlatter::operator()(Reference v) const{
     return i;
   }
 
-  Option<VarInfo> vinfo = vtable[s];
+  const VarInfo *vinfo = vtable.lookup(s);
   if (!vinfo) ERROR("EvalExpFlatter: Variable %s not found !", s.c_str());
-  if (!vinfo.get().modification()) {
+  if (!vinfo->modification()) {
     ERROR("EvalExpFlatter: Variable %s without initial value!", s.c_str());
   }
 
-  Modification m = vinfo.get().modification().get();
+  Modification m = vinfo->modification().get();
 
   if (is<ModEq>(m)){
     Expression meq = boost::get<ModEq>(m).exp();
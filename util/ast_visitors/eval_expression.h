@@ -33,24 +33,24 @@ class EvalExpression : public boost::static_visitor<Real>{
   EvalExpression(const VarSymbolTable &, Name, Real);
   Real operator()(Integer v) const;
   Real operator()(Boolean v) const;
-  Real operator()(String v) const;
-  Real operator()(AddAll v) const;
-  Real operator()(Name v) const;
+  Real operator()(const String &v) const;
+  Real operator()(const AddAll &v) const;
+  Real operator()(const Name &v) const;
   Real operator()(Real v) const;
-  Real operator()(SubEnd v) const;
-  Real operator()(SubAll v) const;
-  Real operator()(BinOp) const;
-  Real operator()(UnaryOp) const;
-  Real operator()(Brace) const;
-  Real operator()(Bracket) const;
-  Real operator()(Call) const;
-  Real operator()(FunctionExp) const;
-  Real operator()(ForExp) const;
-  Real operator()(IfExp) const;
-  Real operator()(Named) const;
-  Real operator()(Output) const;
-  Real operator()(Reference) const;
-  Real operator()(Range) const;
+  Real operator()(const SubEnd &v) const;
+  Real operator()(const SubAll &v) const;
+  Real operator()(const BinOp &) const;
+  Real operator()(const UnaryOp &) const;
+  Real operator()(const Brace &) const;
+  Real operator()(const Bracket &) const;
+  Real operator()(const Call &) const;
+  Real operator()(const FunctionExp &) const;
+  Real operator()(const ForExp &) const;
+  Real operator()(const IfExp &) const;
+  Real operator()(const Named &) const;
+  Real operator()(const Output &) const;
+  Real operator()(const Reference &) const;
+  Real operator()(const Range &) const;
   const VarSymbolTable &vtable;
   Option<Name> name;
   Option<Real> val;
@@ -62,24 +62,24 @@ class EvalExpFlatter{
   EvalExpFlatter(const VarSymbolTable &, Name, Real);
   Interval operator()(Integer v) const;
   Interval operator()(Boolean v) const;
-  Interval operator()(AddAll v) const;
-  Interval operator()(String v) const;
-  Interval operator()(Name v) const;
+  Interval operator()(const AddAll &v) const;
+  Interval operator()(const String &v) const;
+  Interval operator()(const Name &v) const;
   Interval operator()(Real v) const;
-  Interval operator()(SubEnd v) const;
-  Interval operator()(SubAll v) const;
-  Interval operator()(BinOp) const;
-  Interval operator()(UnaryOp) const;
-  Interval operator()(Brace) const;
-  Interval operator()(Bracket) const;
-  Interval operator()(Call) const;
-  Interval operator()(FunctionExp) const;
-  Interval operator()(ForExp) const;
-  Interval operator()(IfExp) const;
-  Interval operator()(Named) const;
-  Interval operator()(Output) const;
-  Interval operator()(Reference) const;
-  Interval operator()(Range) const;
+  Interval operator()(const SubEnd &v) const;
+  Interval operator()(const SubAll &v) const;
+  Interval operator()(const BinOp &) const;
+  Interval operator()(const UnaryOp &) const;
+  Interval operator()(const Brace &) const;
+  Interval operator()(const Bracket &) const;
+  Interval operator()(const Call &) const;
+  Interval operator()(const FunctionExp &) const;
+  Interval operator()(const ForExp &) const;
+  Interval operator()(const IfExp &) const;
+  Interval operator()(const Named &) const;
+  Interval operator()(const Output &) const;
+  Interval operator()(const Reference &) const;
+  Interval operator()(const Range &) const;
   const VarSymbolTable &vtable;
   Option<Name> name;
   Option<Real> val;
@@ -37,27 +37,25 @@ Expression PartialEvalExpression::operator()(Real v) const
   return v;
 }
 Expression PartialEvalExpression::operator()(Boolean v) const { return v; }
-Expression PartialEvalExpression::operator()(AddAll v) const {
+Expression PartialEvalExpression::operator()(const AddAll &v) const {
   WARNING("Not evaluating AddAll exp");
   return v;
 }
-Expression PartialEvalExpression::operator()(String v) const { return v; }
-Expression PartialEvalExpression::operator()(Name v) const { return v; }
+Expression PartialEvalExpression::operator()(const String &v) const { return v; }
+Expression PartialEvalExpression::operator()(const Name &v) const { return v; }
 Expression PartialEvalExpression::operator()(Expression v) const { return v; }
-Expression PartialEvalExpression::operator()(SubAll v) const { return v; }
-Expression PartialEvalExpression::operator()(SubEnd v) const { return v; }
-Expression PartialEvalExpression::operator()(BinOp v) const
+Expression PartialEvalExpression::operator()(const SubAll &v) const { return v; }
+Expression PartialEvalExpression::operator()(const SubEnd &v) const { return v; }
+Expression PartialEvalExpression::operator()(const BinOp &v) const
 {
-  Expression l = v.left(), r = v.right();
-  l = ApplyThis(l);
-  r = ApplyThis(r);
+  Expression l = fold(v.left()), r = fold(v.right());
   if ((is<Real>(l) || is<Integer>(l)) && (is<Real>(r) || is<Integer>(r))) {
     Expression binop = BinOp(l, v.op(), r);
     Expression e = Apply(EvalExpression(vtable), binop);
     if (!is<Real>(l) && !is<Real>(r) && is<Real>(e)) {
       return Integer(get<Real>(e));
     }
-    return Apply(EvalExpression(vtable), binop);
+    return e;
   }
   if (v.op() == Add && isZero(l)) return r;
   if (v.op() == Add && isZero(r)) return l;
@@ -68,10 +66,9 @@ Expression PartialEvalExpression::operator()(BinOp v) const
   if (v.op() == Mult && (isZero(r) || isZero(l))) return 0;
   return BinOp(l, v.op(), r);
 }
-Expression PartialEvalExpression::operator()(UnaryOp v) const
+Expression PartialEvalExpression::operator()(const UnaryOp &v) const
 {
-  Expression e = v.exp();
-  Expression res = ApplyThis(e);
+  Expression res = fold(v.exp());
   if (v.op() == Not && is<Boolean>(res)) {
     if (get<Boolean>(res) == TRUE) return Boolean(FALSE);
     return Boolean(TRUE);
@@ -84,35 +81,32 @@ Expression PartialEvalExpression::operator()(UnaryOp v) const
     return get<UnaryOp>(res).exp();
   return UnaryOp(res, v.op());
 }
-Expression PartialEvalExpression::operator()(IfExp v) const
+Expression PartialEvalExpression::operator()(const IfExp &v) const
 {
   WARNING("Not evaluating If exp");
   return v;
 }
-Expression PartialEvalExpression::operator()(Range v) const
+Expression PartialEvalExpression::operator()(const Range &v) const
 {
-  Expression s = v.start();
-  Expression e = v.end();
-  if (!v.step()) return Range(ApplyThis(s), ApplyThis(e));
-  Expression st = v.step().get();
-  return Range(ApplyThis(s), ApplyThis(st), ApplyThis(e));
+  if (!v.step()) return Range(fold(v.start()), fold(v.end()));
+  return Range(fold(v.start()), fold(v.step().get()), fold(v.end()));
 }
-Expression PartialEvalExpression::operator()(Brace v) const
+Expression PartialEvalExpression::operator()(const Brace &v) const
 {
   WARNING("Not evaluating brace exp");
   return v;
 }
-Expression PartialEvalExpression::operator()(Bracket v) const { return v; }
-Expression PartialEvalExpression::operator()(Call v) const
+Expression PartialEvalExpression::operator()(const Bracket &v) const { return v; }
+Expression PartialEvalExpression::operator()(const Call &v) const
 {
-  ExpList &args = v.args_ref();
-  foreach_(Expression & e, args) e = ApplyThis(e);
-  return v;
+  Call c = v;
+  foreach_(Expression & e, c.args_ref()) e = fold(e);
+  return c;
 }
-Expression PartialEvalExpression::operator()(FunctionExp v) const { return v; }
-Expression PartialEvalExpression::operator()(ForExp v) const { return v; }
-Expression PartialEvalExpression::operator()(Named v) const { return v; }
-Expression PartialEvalExpression::operator()(Output v) const
+Expression PartialEvalExpression::operator()(const FunctionExp &v) const { return v; }
+Expression PartialEvalExpression::operator()(const ForExp &v) const { return v; }
+Expression PartialEvalExpression::operator()(const Named &v) const { return v; }
+Expression PartialEvalExpression::operator()(const Output &v) const
 {
   if (v.args().size() == 1 && v.args().front()) {
     Expression e = v.args().front().get();
@@ -123,16 +117,16 @@ Expression PartialEvalExpression::operator()(Output v) const
   }
   return v;
 }
-Expression PartialEvalExpression::operator()(Reference v) const
+Expression PartialEvalExpression::operator()(const Reference &v) const
 {
-  Ref r = v.ref();
+  const Ref &r = v.ref();
   ERROR_UNLESS(r.size() == 1, "PartialEvalExpression conversion of dotted references not implemented");
-  Option<ExpList> oel = boost::get<1>(r[0]);
-  Name s = boost::get<0>(r[0]);
-  if ((isConstant(s, vtable) || isParameter(s, vtable)) && (!oel || (oel && oel.get().size() == 0))) {
-    Option<VarInfo> vinfo = vtable[s];
+  const ExpList &subs = boost::get<1>(r[0]);
+  const Symbol &s = boost::get<0>(r[0]);
+  if (foldable(s) && subs.empty()) {
+    const VarInfo *vinfo = vtable.lookup(s);
     if (!vinfo) ERROR("Variable %s not found", s.c_str());
-    if (vinfo.get().type() == "Integer" && vinfo.get().modification()) {  // evaluate integer parameters
+    if (vinfo->type() == "Integer" && vinfo->modification()) {  // evaluate integer parameters
       Expression vv = v;
       Real ret = Apply(EvalExpression(vtable), vv);
       const int i = ret;
@@ -142,13 +136,13 @@ Expression PartialEvalExpression::operator()(Reference v) const
       }
       if (ret < 0) return Output(Real(ret));
       return Real(ret);
-    } else if (vinfo.get().type() == "Boolean" && vinfo.get().modification()) {  // evaluate boolean parameters
+    } else if (vinfo->type() == "Boolean" && vinfo->modification()) {  // evaluate boolean parameters
       Expression vv = v;
       Real ret = Apply(EvalExpression(vtable), vv);
       if (ret == 1.0) return Boolean(TRUE);
       return Boolean(FALSE);
-    } else if (eval_parameters && vinfo.get().type() == "Real" && !vinfo.get().indices() &&
-               vinfo.get().modification()) {  // evaluate scalar parameters
+    } else if (eval_parameters && vinfo->type() == "Real" && !vinfo->indices() &&
+               vinfo->modification()) {  // evaluate scalar parameters
       Expression vv = v;
       Real ret = Apply(EvalExpression(vtable), vv);
       if (ret < 0) return Output(Real(ret));
@@ -157,11 +151,76 @@ Expression PartialEvalExpression::operator()(Reference v) const
       return v;
     }
   }
-  if (oel) {
-    ExpList nl;
-    foreach_(Expression e, oel.get()) { nl.push_back(ApplyThis(e)); }
-    return Reference(Ref(1, RefTuple(s, nl)));
+  ExpList nl;
+  foreach_(const Expression &e, subs) { nl.push_back(fold(e)); }
+  return Reference(Ref(1, RefTuple(s, nl)));
+}
+
+Expression PartialEvalExpression::fold(const Expression &e) const
+{
+  if (constantFree(e)) return e;
+  return ApplyThis(e);
+}
+
+void PartialEvalExpression::simplify(Expression &e) const
+{
+  if (constantFree(e)) return;
+  boost::unordered_map<Expression, Expression>::const_iterator it = cache_.find(e);
+  if (it != cache_.end()) {
+    e = it->second;
+    return;
   }
-  return v;
+  Expression res = ApplyThis(e);
+  e = cache_.emplace(std::move(e), std::move(res)).first->second;
+}
+
+bool PartialEvalExpression::constantFree(const Expression &e) const
+{
+  if (is<Integer>(e) || is<Real>(e) || is<Boolean>(e)) return false;
+  // Left as they are but with a warning, keep visiting them
+  if (is<AddAll>(e) || is<IfExp>(e) || is<Brace>(e)) return false;
+  if (is<BinOp>(e)) {
+    const BinOp &b = get<BinOp>(e);
+    return constantFree(b.left()) && constantFree(b.right());
+  }
+  if (is<UnaryOp>(e)) {
+    const UnaryOp &u = get<UnaryOp>(e);
+    if (u.op() == Minus && is<UnaryOp>(u.exp()) && get<UnaryOp>(u.exp()).op() == Minus) return false;
+    return constantFree(u.exp());
+  }
+  if (is<Range>(e)) {
+    const Range &r = get<Range>(e);
+    return constantFree(r.start()) && constantFree(r.end()) && (!r.step() || constantFree(r.step().get()));
+  }
+  if (is<Call>(e)) {
+    foreach_(const Expression &a, get<Call>(e).args())
+      if (!constantFree(a)) return false;
+    return true;
+  }
+  if (is<Output>(e)) {
+    const Output &o = get<Output>(e);
+    if (o.args().size() != 1 || !o.args().front()) return true;
+    const Expression &a = o.args().front().get();
+    return !is<UnaryOp>(a) && constantFree(a);
+  }
+  if (is<Reference>(e)) {
+    const Ref &r = get<Reference>(e).ref();
+    if (r.size() != 1) return false;
+    const ExpList &subs = boost::get<1>(r[0]);
+    if (foldable(boost::get<0>(r[0])) && subs.empty()) return false;
+    foreach_(const Expression &i, subs)
+      if (!constantFree(i)) return false;
+    return true;
+  }
+  return true;
+}
+
+bool PartialEvalExpression::foldable(const Symbol &s) const
+{
+  boost::unordered_map<Symbol, bool>::const_iterator it = foldable_.find(s);
+  if (it != foldable_.end()) return it->second;
+  bool ret = isConstant(s, vtable) || isParameter(s, vtable);
+  foldable_.insert(std::make_pair(s, ret));
+  return ret;
 }
 }  // namespace Modelica
@@ -19,6 +19,7 @@
 
 #ifndef AST_VISITOR_PARTEVALEXP
 #define AST_VISITOR_PARTEVALEXP
+#include <boost/unordered_map.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <ast/expression.h>
 #include <util/table.h>
@@ -32,26 +33,42 @@ class PartialEvalExpression : public boost::static_visitor<Expression> {
   Expression operator()(Integer v) const;
   Expression operator()(Real v) const;
   Expression operator()(Boolean v) const;
-  Expression operator()(AddAll v) const;
-  Expression operator()(String v) const;
-  Expression operator()(Name v) const;
+  Expression operator()(const AddAll &v) const;
+  Expression operator()(const String &v) const;
+  Expression operator()(const Name &v) const;
   Expression operator()(Expression v) const;
-  Expression operator()(SubEnd v) const;
-  Expression operator()(SubAll v) const;
-  Expression operator()(BinOp) const;
-  Expression operator()(UnaryOp) const;
-  Expression operator()(Brace) const;
-  Expression operator()(Bracket) const;
-  Expression operator()(Call) const;
-  Expression operator()(FunctionExp) const;
-  Expression operator()(ForExp) const;
-  Expression operator()(IfExp) const;
-  Expression operator()(Named) const;
-  Expression operator()(Output) const;
-  Expression operator()(Reference) const;
-  Expression operator()(Range) const;
+  Expression operator()(const SubEnd &v) const;
+  Expression operator()(const SubAll &v) const;
+  Expression operator()(const BinOp &) const;
+  Expression operator()(const UnaryOp &) const;
+  Expression operator()(const Brace &) const;
+  Expression operator()(const Bracket &) const;
+  Expression operator()(const Call &) const;
+  Expression operator()(const FunctionExp &) const;
+  Expression operator()(const ForExp &) const;
+  Expression operator()(const IfExp &) const;
+  Expression operator()(const Named &) const;
+  Expression operator()(const Output &) const;
+  Expression operator()(const Reference &) const;
+  Expression operator()(const Range &) const;
+  /// @brief Partially evaluates an expression in place.
+  ///
+  /// Expressions with nothing to fold are left untouched and the results are
+  /// remembered, so simplifying an unchanged expression again with the same
+  /// evaluator is a single lookup. Assumes the values of the constants and
+  /// parameters in the table do not change while the evaluator is in use.
+  void simplify(Expression &) const;
+  /// @brief True when partial evaluation would leave the expression as it is
+  bool constantFree(const Expression &) const;
   const VarSymbolTable &vtable;
   bool eval_parameters;
+
+  private:
+  Expression fold(const Expression &) const;
+  /// @brief True for constants and parameters, which may be replaced by their value
+  bool foldable(const Symbol &) const;
+  mutable boost::unordered_map<Expression, Expression> cache_;
+  mutable boost::unordered_map<Symbol, bool> foldable_;
 };
 }  // namespace Modelica
 #endif
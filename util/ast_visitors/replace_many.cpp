@@ -0,0 +1,236 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#include <boost/variant/get.hpp>
+
+#include <ast/queries.h>
+#include <util/debug.h>
+#include <util/ast_visitors/replace_many.h>
+
+namespace Modelica {
+
+static const ReplaceArrayMap noArrays;
+
+// BinOp prints without parentheses, so an operand that is not atomic is
+// wrapped before it is scaled
+static Expression grouped(const Expression &e)
+{
+  if (is<Integer>(e) || is<Reference>(e) || is<Output>(e)) return e;
+  return Output(e);
+}
+
+ReplaceMany::ReplaceMany(const ReplaceMap &m) : map(m), arrays(noArrays){};
+ReplaceMany::ReplaceMany(const ReplaceMap &m, const ReplaceArrayMap &a) : map(m), arrays(a){};
+Expression ReplaceMany::operator()(Integer v) const { return v; }
+Expression ReplaceMany::operator()(Boolean v) const { return v; }
+Expression ReplaceMany::operator()(const AddAll &v) const { return v; }
+Expression ReplaceMany::operator()(const String &v) const { return v; }
+Expression ReplaceMany::operator()(const Name &v) const { return v; }
+Expression ReplaceMany::operator()(Real v) const { return v; }
+Expression ReplaceMany::operator()(const SubEnd &v) const { return v; }
+Expression ReplaceMany::operator()(const SubAll &v) const { return v; }
+Expression ReplaceMany::operator()(const BinOp &v) const { return BinOp(ApplyThis(v.left()), v.op(), ApplyThis(v.right())); }
+Expression ReplaceMany::operator()(const UnaryOp &v) const { return UnaryOp(ApplyThis(v.exp()), v.op()); }
+Expression ReplaceMany::operator()(const IfExp &v) const
+{
+  List<ExpPair> elseif;
+  foreach_(const ExpPair &p, v.elseif()) elseif.push_back(ExpPair(ApplyThis(get<0>(p)), ApplyThis(get<1>(p))));
+  return IfExp(ApplyThis(v.cond()), ApplyThis(v.then()), elseif, ApplyThis(v.elseexp()));
+}
+Expression ReplaceMany::operator()(const Range &v) const
+{
+  if (!v.step()) return Range(ApplyThis(v.start()), ApplyThis(v.end()));
+  return Range(ApplyThis(v.start()), ApplyThis(v.step().get()), ApplyThis(v.end()));
+}
+Expression ReplaceMany::operator()(const Brace &v) const
+{
+  ExpList args;
+  foreach_(const Expression &e, v.args()) args.push_back(ApplyThis(e));
+  return Brace(args);
+}
+Expression ReplaceMany::operator()(const Bracket &v) const { return v; }
+Expression ReplaceMany::operator()(const Call &v) const
+{
+  ExpList args;
+  foreach_(const Expression &e, v.args()) args.push_back(ApplyThis(e));
+  return Call(v.name(), args);
+}
+Expression ReplaceMany::operator()(const FunctionExp &v) const { return v; }
+Expression ReplaceMany::operator()(const ForExp &v) const { return v; }
+Expression ReplaceMany::operator()(const Named &v) const { return v; }
+Expression ReplaceMany::operator()(const Output &v) const
+{
+  OptExpList args;
+  foreach_(const OptExp &oe, v.args())
+  {
+    if (oe)
+      args.push_back(ApplyThis(oe.get()));
+    else
+      args.push_back(oe);
+  }
+  return Output(args);
+}
+Expression ReplaceMany::operator()(const Reference &v) const
+{
+  const Ref &r = v.ref();
+  ReplaceMap::const_iterator it = map.find(get<0>(r.front()));
+  if (it != map.end() && r.size() == 1 && get<1>(r.front()).empty()) return it->second;
+  Ref aux;
+  foreach_(const RefTuple &rt, r)
+  {
+    ExpList exps;
+    foreach_(const Expression &e, get<1>(rt)) exps.push_back(ApplyThis(e));
+    aux.push_back(RefTuple(get<0>(rt), exps));
+  }
+  if (it != map.end() && is<Reference>(it->second)) get<0>(aux.front()) = refName(get<Reference>(it->second));
+  if (!arrays.empty() && r.size() == 1) {
+    ReplaceArrayMap::const_iterator at = arrays.find(get<0>(r.front()));
+    if (at != arrays.end()) {
+      const ArrayRename &ar = at->second;
+      ExpList &subs = get<1>(aux.front());
+      get<0>(aux.front()) = ar.name;
+      if (subs.empty() && (ar.gain != 1 || ar.offset != 0)) subs.push_back(SubAll());
+      if (!subs.empty()) subs.front() = shiftIndex(subs.front(), ar);
+      if (ar.negated) return UnaryOp(Reference(aux), Minus);
+      return Reference(aux);
+    }
+  }
+  return Reference(aux);
+}
+Expression ReplaceMany::shiftIndex(const Expression &e, const ArrayRename &ar) const
+{
+  if (ar.gain == 1 && ar.offset == 0) return e;
+  if (is<Integer>(e)) return Integer(ar.gain * get<Integer>(e) + ar.offset);
+  if (is<SubAll>(e)) {
+    if (ar.gain == 1) return Range(Integer(1 + ar.offset), Integer(ar.size + ar.offset));
+    return Range(Integer(ar.gain + ar.offset), Integer(ar.gain), Integer(ar.gain * ar.size + ar.offset));
+  }
+  if (is<Range>(e)) {
+    const Range &rng = get<Range>(e);
+    if (ar.gain == 1 && !rng.step()) return Range(shiftIndex(rng.start(), ar), shiftIndex(rng.end(), ar));
+    Expression step = rng.step() ? rng.step().get() : Expression(Integer(1));
+    if (ar.gain != 1) step = BinOp(Integer(ar.gain), Mult, grouped(step));
+    return Range(shiftIndex(rng.start(), ar), step, shiftIndex(rng.end(), ar));
+  }
+  Expression scaled = ar.gain == 1 ? e : Expression(BinOp(Integer(ar.gain), Mult, grouped(e)));
+  if (ar.offset > 0) return BinOp(scaled, Add, Integer(ar.offset));
+  if (ar.offset < 0) return BinOp(scaled, Sub, Integer(-ar.offset));
+  return scaled;
+}
+
+ReplaceManyEquation::ReplaceManyEquation(const ReplaceMap &m) : replace_exp(m){};
+ReplaceManyEquation::ReplaceManyEquation(const ReplaceMap &m, const ReplaceArrayMap &a) : replace_exp(m, a){};
+Equation ReplaceManyEquation::operator()(Connect v) const
+{
+  ERROR("Replace in connect equation not implemented\n");
+  return v;
+}
+Equation ReplaceManyEquation::operator()(Equality v) const
+{
+  v.left_ref() = Apply(replace_exp, v.left_ref());
+  v.right_ref() = Apply(replace_exp, v.right_ref());
+  return v;
+}
+Equation ReplaceManyEquation::operator()(IfEq v) const
+{
+  ERROR("Replace in if equation not implemented\n");
+  return v;
+}
+Equation ReplaceManyEquation::operator()(CallEq v) const
+{
+  ERROR("Replace in call equation not implemented\n");
+  return v;
+}
+Equation ReplaceManyEquation::operator()(ForEq v) const
+{
+  foreach_(Index & i, v.range_ref().indexes_ref())
+  {
+    if (i.exp()) i.exp_ref() = Apply(replace_exp, i.exp_ref().get());
+  }
+  foreach_(Equation & e, v.elements_ref()) e = ApplyThis(e);
+  return v;
+}
+Equation ReplaceManyEquation::operator()(WhenEq v) const
+{
+  ERROR("Replace in when equation not implemented\n");
+  return v;
+}
+
+ReplaceManyStatement::ReplaceManyStatement(const ReplaceMap &m) : replace_exp(m){};
+ReplaceManyStatement::ReplaceManyStatement(const ReplaceMap &m, const ReplaceArrayMap &a) : replace_exp(m, a){};
+Statement ReplaceManyStatement::operator()(Break v) const { return v; }
+Statement ReplaceManyStatement::operator()(Return v) const { return v; }
+Statement ReplaceManyStatement::operator()(Assign v) const
+{
+  if (v.rl()) {
+    foreach_(Expression & e, v.rl_ref().get()) e = Apply(replace_exp, e);
+  }
+  v.left_ref() = Apply(replace_exp, v.left_ref());
+  if (v.right()) v.right_ref() = Apply(replace_exp, v.right_ref().get());
+  return v;
+}
+Statement ReplaceManyStatement::operator()(IfSt v) const
+{
+  v.cond_ref() = Apply(replace_exp, v.cond_ref());
+  foreach_(Statement & st, v.elements_ref()) st = ApplyThis(st);
+  foreach_(Statement & st, v.ifnot_ref()) st = ApplyThis(st);
+  foreach_(If<Statement>::Else & els, v.elseif_ref())
+  {
+    get<0>(els) = Apply(replace_exp, get<0>(els));
+    foreach_(Statement & st, get<1>(els)) st = ApplyThis(st);
+  }
+  return v;
+}
+Statement ReplaceManyStatement::operator()(CallSt v) const
+{
+  v.n_ref() = Apply(replace_exp, v.n_ref());
+  foreach_(Expression & e, v.arg_ref()) e = Apply(replace_exp, e);
+  foreach_(OptExp & oe, v.out_ref())
+  {
+    if (oe) oe = Apply(replace_exp, oe.get());
+  }
+  return v;
+}
+Statement ReplaceManyStatement::operator()(ForSt v) const
+{
+  foreach_(Index & i, v.range_ref().indexes_ref())
+  {
+    if (i.exp()) i.exp_ref() = Apply(replace_exp, i.exp_ref().get());
+  }
+  foreach_(Statement & s, v.elements_ref()) s = ApplyThis(s);
+  return v;
+}
+Statement ReplaceManyStatement::operator()(WhenSt v) const
+{
+  v.cond_ref() = Apply(replace_exp, v.cond_ref());
+  foreach_(Statement & st, v.elements_ref()) st = ApplyThis(st);
+  foreach_(When<Statement>::Else & els, v.elsewhen_ref())
+  {
+    get<0>(els) = Apply(replace_exp, get<0>(els));
+    foreach_(Statement & st, get<1>(els)) st = ApplyThis(st);
+  }
+  return v;
+}
+Statement ReplaceManyStatement::operator()(WhileSt v) const
+{
+  ERROR("Replace in while statement not implemented\n");
+  return v;
+}
+}  // namespace Modelica
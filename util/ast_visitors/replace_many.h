@@ -0,0 +1,120 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#ifndef AST_VISITOR_REPLACE_MANY
+#define AST_VISITOR_REPLACE_MANY
+#include <boost/unordered_map.hpp>
+#include <boost/variant/static_visitor.hpp>
+#include <ast/equation.h>
+#include <ast/statement.h>
+
+namespace Modelica {
+
+using namespace Modelica::AST;
+
+/// @brief Substitution of many variables at once, keyed by variable name
+typedef boost::unordered_map<Symbol, Expression> ReplaceMap;
+
+/// @brief Renaming of a one-dimensional array with an affine change of index.
+///
+/// Element a[k] of the renamed array becomes (minus, if negated) name[gain * k + offset];
+/// a reference to the whole array becomes the slice of name it covers.
+struct ArrayRename {
+  ArrayRename() : gain(1), offset(0), size(0), negated(false){};
+  ArrayRename(Name n, Integer g, Integer o, Integer s, bool neg) : name(n), gain(g), offset(o), size(s), negated(neg){};
+  Name name;
+  Integer gain, offset;
+  /// Number of elements of the renamed array, only needed to slice when the map is not the identity
+  Integer size;
+  bool negated;
+};
+
+/// @brief Array renamings, keyed by the name of the renamed array
+typedef boost::unordered_map<Symbol, ArrayRename> ReplaceArrayMap;
+
+/// @brief Replaces every variable of a ReplaceMap in a single traversal.
+///
+/// Plain references to a variable are replaced by its expression. Subscripted
+/// references are renamed when the replacement is itself a reference, as
+/// ReplaceExpression does with ignoreIndexes. Arrays of a ReplaceArrayMap are
+/// renamed with their subscripts shifted.
+class ReplaceMany : public boost::static_visitor<Expression> {
+  public:
+  ReplaceMany(const ReplaceMap &);
+  ReplaceMany(const ReplaceMap &, const ReplaceArrayMap &);
+  Expression operator()(Integer v) const;
+  Expression operator()(Boolean v) const;
+  Expression operator()(const AddAll &v) const;
+  Expression operator()(const String &v) const;
+  Expression operator()(const Name &v) const;
+  Expression operator()(Real v) const;
+  Expression operator()(const SubEnd &v) const;
+  Expression operator()(const SubAll &v) const;
+  Expression operator()(const BinOp &) const;
+  Expression operator()(const UnaryOp &) const;
+  Expression operator()(const Brace &) const;
+  Expression operator()(const Bracket &) const;
+  Expression operator()(const Call &) const;
+  Expression operator()(const FunctionExp &) const;
+  Expression operator()(const ForExp &) const;
+  Expression operator()(const IfExp &) const;
+  Expression operator()(const Named &) const;
+  Expression operator()(const Output &) const;
+  Expression operator()(const Reference &) const;
+  Expression operator()(const Range &) const;
+
+  const ReplaceMap &map;
+  const ReplaceArrayMap &arrays;
+
+  private:
+  Expression shiftIndex(const Expression &, const ArrayRename &) const;
+};
+
+class ReplaceManyEquation : public boost::static_visitor<Equation> {
+  public:
+  ReplaceManyEquation(const ReplaceMap &);
+  ReplaceManyEquation(const ReplaceMap &, const ReplaceArrayMap &);
+  Equation operator()(Connect) const;
+  Equation operator()(Equality) const;
+  Equation operator()(CallEq) const;
+  Equation operator()(ForEq) const;
+  Equation operator()(IfEq) const;
+  Equation operator()(WhenEq) const;
+
+  ReplaceMany replace_exp;
+};
+
+class ReplaceManyStatement : public boost::static_visitor<Statement> {
+  public:
+  ReplaceManyStatement(const ReplaceMap &);
+  ReplaceManyStatement(const ReplaceMap &, const ReplaceArrayMap &);
+  Statement operator()(Assign) const;
+  Statement operator()(Break) const;
+  Statement operator()(Return) const;
+  Statement operator()(CallSt) const;
+  Statement operator()(IfSt) const;
+  Statement operator()(WhenSt) const;
+  Statement operator()(WhileSt) const;
+  Statement operator()(ForSt) const;
+
+  ReplaceMany replace_exp;
+};
+}  // namespace Modelica
+#endif
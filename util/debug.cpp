@@ -24,6 +24,8 @@
 #include <string.h>
 #include <stdarg.h>
 
+#include <util/thread_pool.h>
+
 static const char *enableFlags = NULL;  // controls which DEBUG messages are printed
 
 void debugInit(const char *flagList) { enableFlags = flagList; }
@@ -77,7 +79,7 @@ void ERROR(const char *format, ...)
   fflush(stderr);
   va_end(ap);
   delete[] new_format;
-  exit(EXIT_FAILURE);
+  fatalExit(EXIT_FAILURE);
 }
 
 void ERROR_UNLESS(bool condition, const char *format, ...)
@@ -40,7 +40,8 @@ bool isDebugParam(char *param);
 bool debugIsEnabled(char);
 
 /*
- * Print an ERROR message. Then exits with EXIT_FAILURE status.
+ * Print an ERROR message. Then exits with EXIT_FAILURE status, from the
+ * calling thread when it happens inside a parallelFor job (see fatalExit).
  */
 void ERROR(const char *format, ...);
 
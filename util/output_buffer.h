@@ -0,0 +1,88 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <unistd.h>
+#include <cerrno>
+#include <streambuf>
+#include <string>
+
+/**
+ * A stream buffer that collects everything inserted into an std::ostream in
+ * a string, for printers that produce a lot of text. Nothing is flushed per
+ * line: when a file descriptor is given, the text is written to it in one
+ * write(2) call every time more than capacity bytes have piled up, and on
+ * flush().
+ */
+class OutputBuffer : public std::streambuf {
+  public:
+  explicit OutputBuffer(int fd = -1, size_t capacity = 1 << 16) : fd_(fd), capacity_(capacity), failed_(false)
+  {
+    text_.reserve(fd < 0 ? 0 : capacity + capacity / 4);
+  }
+  ~OutputBuffer() { flush(); }
+  const std::string &text() const { return text_; }
+  /// @brief Writes the pending text to the file descriptor, if there is one.
+  /// Returns false if this or an earlier write failed.
+  bool flush()
+  {
+    if (fd_ < 0) return !failed_;
+    const char *p = text_.data();
+    size_t left = text_.size();
+    while (left && !failed_) {
+      ssize_t n = ::write(fd_, p, left);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) failed_ = true;
+      else {
+        p += n;
+        left -= n;
+      }
+    }
+    text_.clear();
+    return !failed_;
+  }
+
+  protected:
+  int_type overflow(int_type c)
+  {
+    if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+    text_.push_back(traits_type::to_char_type(c));
+    if (fd_ >= 0 && text_.size() >= capacity_) flush();
+    return c;
+  }
+  std::streamsize xsputn(const char *s, std::streamsize n)
+  {
+    text_.append(s, n);
+    if (fd_ >= 0 && text_.size() >= capacity_) flush();
+    return n;
+  }
+  int sync() { return flush() ? 0 : -1; }
+
+  private:
+  OutputBuffer(const OutputBuffer &);
+  OutputBuffer &operator=(const OutputBuffer &);
+  int fd_;
+  size_t capacity_;
+  bool failed_;
+  std::string text_;
+};
+
+#endif
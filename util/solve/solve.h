@@ -28,9 +28,19 @@
 using namespace Modelica::AST;
 class EquationSolver {
   public:
+  /// @brief Solves eqs for crs. Non-linear systems are solved by a GSL
+  /// function named fsolveN, where N is taken from (and increments) fsolve.
   static EquationList Solve(EquationList eqs, ExpList crs, VarSymbolTable &syms, std::list<std::string> &c_code, ClassList &cl,
-                            const std::string path);
+                            const std::string path, int &fsolve);
   static Equation Solve(Equation eq, Expression exp, VarSymbolTable &syms, std::list<std::string> &c_code, ClassList &cl,
-                        const std::string path);
+                        const std::string path, int &fsolve);
+  /// @brief Tries to solve eqs for crs symbolically. Returns false if the
+  /// system is not linear in crs. It can be called from several threads at
+  /// once: the calls into GiNaC, which is not thread safe, are serialized.
+  static bool SolveLinear(EquationList eqs, ExpList crs, VarSymbolTable &syms, EquationList &ret);
+  /// @brief Generates the GSL function fsolveN solving eqs for crs and
+  /// returns the equation calling it.
+  static EquationList SolveNonLinear(EquationList eqs, ExpList crs, VarSymbolTable &syms, std::list<std::string> &c_code, ClassList &cl,
+                                     const std::string path, int &fsolve);
 };
 #endif
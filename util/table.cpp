@@ -20,6 +20,8 @@
 #include <util/table.h>
 // Si se usa type.h si o si tiene que estar mmo_class.h. No se puede ṕoner dentro de type.h
 #include <mmo/mmo_class.h>
+#include <algorithm>
+#include <vector>
 
 using namespace Modelica::AST;
 
@@ -67,10 +69,16 @@ std::ostream& operator<<(std::ostream& out, const VarInfo& v)  // output
 }
 
 std::ostream &operator<<(std::ostream &out, const VarSymbolTable &vst){
-  typename std::map<Name, VarInfo>::const_iterator it;
+  // The table is unordered, print it by name so dumps can be compared
+  std::vector<const VarSymbolTable::value_type *> entries;
+  VarSymbolTable::const_iterator it;
+  for(it = vst.begin(); it != vst.end(); ++it) entries.push_back(&*it);
+  std::sort(entries.begin(), entries.end(), [](const VarSymbolTable::value_type *a, const VarSymbolTable::value_type *b) {
+    return a->first.str() < b->first.str();
+  });
 
-  for(it = vst.begin(); it != vst.end(); ++it){
-    out << it->first << ": " << it->second << "\n";
+  foreach_(const VarSymbolTable::value_type *e, entries){
+    out << e->first << ": " << e->second << "\n";
   }
 
   return out;
@@ -22,30 +22,54 @@
 
 #include <map>
 #include <string>
+#include <boost/unordered_map.hpp>
 #include <ast/ast_types.h>
 #include <ast/class.h>
+#include <ast/symbol.h>
 #include <util/type.h>
 
-template <typename Key, typename Value>
-struct SymbolTable : public std::map<Key, Value> {
-  void insert(Key k, Value v)
+/**
+ * A symbol table can be a scope layered over a parent table: lookups that
+ * miss the scope fall back to the parent, so adding a few bindings (e.g. a
+ * for index) does not require copying the whole parent. The parent must
+ * outlive the scope. Iteration, remove and dump only see the scope's own
+ * entries.
+ *
+ * The underlying container is a std::map unless Map says otherwise. Tables
+ * whose iteration order does not matter can use a hash map.
+ */
+template <typename Key, typename Value, typename Map = std::map<Key, Value> >
+struct SymbolTable : public Map {
+  SymbolTable() : parent_(NULL){};
+  explicit SymbolTable(const SymbolTable *parent) : parent_(parent){};
+  void insert(const Key &k, const Value &v)
   {
-    std::map<Key, Value>::erase(k);
-    std::map<Key, Value>::insert(std::pair<Key, Value>(k, v));
+    std::pair<typename Map::iterator, bool> it = Map::insert(typename Map::value_type(k, v));
+    if (!it.second) it.first->second = v;
   }
-  Option<Value> operator[](Key k) const
+  /// @brief The value bound to k in this scope or its parents, NULL if there is none
+  const Value *lookup(const Key &k) const
   {
-    if (std::map<Key, Value>::find(k) == std::map<Key, Value>::end()) return Option<Value>();
-    return std::map<Key, Value>::at(k);
+    typename Map::const_iterator it = Map::find(k);
+    if (it != Map::end()) return &it->second;
+    if (parent_) return parent_->lookup(k);
+    return NULL;
   }
-  void remove(Key k) { std::map<Key, Value>::erase(k); }
+  Option<Value> operator[](const Key &k) const
+  {
+    const Value *v = lookup(k);
+    if (v) return *v;
+    return Option<Value>();
+  }
+  void remove(const Key &k) { Map::erase(k); }
   void dump()
   {
-    typename std::map<Key, Value>::iterator it;
-    for (it = std::map<Key, Value>::begin(); it != std::map<Key, Value>::end(); it++) {
+    typename Map::iterator it;
+    for (it = Map::begin(); it != Map::end(); it++) {
       std::cerr << it->first << ":" /*<< it->second */ << "\n";
     }
   }
+  const SymbolTable *parent_;
 };
 
 using namespace Modelica::AST;
@@ -69,14 +93,21 @@ struct VarInfo {
   void removePrefix(TypePrefix);
 };
 
-struct VarSymbolTable : public SymbolTable<Name, VarInfo> {
-  typedef std::map<Name, VarInfo> table_type;
+/**
+ * Variables are keyed by their interned name, so a lookup with a Symbol
+ * (e.g. the name in a RefTuple) hashes and compares pointers only. Lookups
+ * with a plain Name intern it first.
+ */
+struct VarSymbolTable : public SymbolTable<Symbol, VarInfo, boost::unordered_map<Symbol, VarInfo> > {
+  typedef boost::unordered_map<Symbol, VarInfo> table_type;
   VarSymbolTable()
   {
     VarInfo v(TypePrefixes(), "Real");
     v.builtin_ref() = true;
     insert("time", v);
   }
+  /// @brief An empty scope over parent
+  explicit VarSymbolTable(const VarSymbolTable *parent) : SymbolTable<Symbol, VarInfo, table_type>(parent){};
 
   friend std::ostream &operator<<(std::ostream &out, const VarSymbolTable &);
 };
@@ -0,0 +1,102 @@
+/*****************************************************************************
+
+    This file is part of Modelica C Compiler.
+
+    Modelica C Compiler is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Modelica C Compiler is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Modelica C Compiler.  If not, see <http://www.gnu.org/licenses/>.
+
+******************************************************************************/
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Thrown by fatalExit on a worker thread of parallelFor, so that the process
+/// exits from the calling thread once every worker has stopped.
+struct JobExit {
+  int status;
+};
+
+/// @brief True on the worker threads of parallelFor
+inline bool &onWorkerThread()
+{
+  static thread_local bool worker = false;
+  return worker;
+}
+
+/// @brief exit(status), or a JobExit when called from a parallelFor worker
+[[noreturn]] inline void fatalExit(int status)
+{
+  if (onWorkerThread()) throw JobExit{status};
+  exit(status);
+}
+
+/**
+ * Runs job(i) for every i in [0, n) on a pool of at most jobs worker threads.
+ * Work items are handed out in increasing order of i. Jobs must store their
+ * results by index so that the caller can assemble them deterministically
+ * once parallelFor returns.
+ *
+ * If a job throws, no further items are handed out and, once every worker
+ * has been joined, the exception of the failed item with the lowest index is
+ * rethrown on the calling thread. A JobExit (from fatalExit or ERROR) exits
+ * the process from the calling thread instead.
+ *
+ * With jobs <= 1 every job runs sequentially on the calling thread.
+ */
+template <typename Job>
+void parallelFor(size_t n, int jobs, Job job)
+{
+  if (jobs <= 1 || n <= 1) {
+    for (size_t i = 0; i < n; i++) job(i);
+    return;
+  }
+  std::atomic<size_t> next(0);
+  std::mutex failure_mutex;
+  std::exception_ptr failure;
+  size_t failed = n;
+  std::vector<std::thread> workers;
+  for (int w = 0; w < jobs && w < (int)n; w++) {
+    workers.push_back(std::thread([&, n]() {
+      onWorkerThread() = true;
+      for (size_t i = next++; i < n; i = next++) {
+        try {
+          job(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(failure_mutex);
+          if (i < failed) {
+            failed = i;
+            failure = std::current_exception();
+          }
+          next = n;
+        }
+      }
+    }));
+  }
+  for (std::thread &t : workers) t.join();
+  if (!failure) return;
+  try {
+    std::rethrow_exception(failure);
+  } catch (const JobExit &e) {
+    exit(e.status);
+  }
+}
+
+#endif
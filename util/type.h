@@ -127,7 +127,7 @@ struct Function {
 };
 
 template <typename T>
-bool is(Type e)
+bool is(const Type &e)
 {
   return e.type() == typeid(T);
 }